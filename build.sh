@@ -1 +1,12 @@
-gcc -shared -fPIC -o armlib.so src/armcat.c src/disasm.c src/decode.c -fsanitize=address, -g3
\ No newline at end of file
+if [ "$1" = "sweep" ]; then
+  gcc -O2 -pthread ${CFLAGS} -o armcat-sweep src/sweep.c src/disasm.c src/decode.c
+  exit
+fi
+
+if [ "$1" = "freestanding" ]; then
+  ${CC:-gcc} -Os -ffreestanding -fno-asynchronous-unwind-tables -nostdlib -r -DARMCAT_FREESTANDING ${CFLAGS} -o armcat-freestanding.o src/armcat.c src/disasm.c src/decode.c
+  ${SIZE:-size} -A armcat-freestanding.o | grep -E "^(section|\.text|\.rodata|\.data|\.bss|Total)"
+  exit
+fi
+
+gcc -shared -fPIC -o armlib.so src/armcat.c src/disasm.c src/decode.c src/batch.c src/classify.c src/symbol.c src/diff.c src/profile.c src/daemon.c src/emulate.c src/hexfile.c src/live.c src/pagecache.c src/pattern.c -fsanitize=address, -g3
\ No newline at end of file
@@ -28,12 +28,37 @@
 */
 
 
+/**
+ * @brief Disassembles a given buffer into caller-supplied storage, without allocating.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @param instructions The array that receives the disassembly data.
+ * @param capacity The amount of instructions the array can hold.
+ * @returns The amount of instructions disassembled, resume from there when the array fills up.
+ */
+
+size_t armcat_disasm_into(const void *buffer, const size_t nbytes, armcat_instr_t *instructions,
+  const size_t capacity)
+{
+  const size_t ninstr = (nbytes / ARMCAT_INSTR_SIZEMAX < capacity) ? nbytes / ARMCAT_INSTR_SIZEMAX : capacity;
+
+  for (size_t i = 0; i < ninstr; ++i) {
+    instructions[i] = (armcat_instr_t){0};
+    disasm_instr(&instructions[i], *(uint32_t *)(buffer + i * ARMCAT_INSTR_SIZEMAX));
+  }
+
+  return ninstr;
+}
+
+#ifndef ARMCAT_FREESTANDING
+
 /**
  * @brief Deallocates the memory that was allocated for the disassembly object.
  * @param disassembly The disassembly object.
  */
 
 void armcat_free(armcat_disasm_t *disassembly) {
+  free(disassembly->valid);
   free(disassembly->instructions);
   free(disassembly);
 }
@@ -58,13 +83,22 @@ armcat_disasm_t *armcat_disasm(const void *buffer, const size_t nbytes) {
     return NULL;
   }
 
+  if (!(disassembly->valid = calloc((disassembly->ninstr + 63) / 64, sizeof(uint64_t)))) {
+    armcat_free(disassembly);
+
+    return NULL;
+  }
+
   for (size_t i = 0, pc = 0; i < disassembly->ninstr; ++i, pc += ARMCAT_INSTR_SIZEMAX) {
-    disasm_instr(&disassembly->instructions[i], *(uint32_t *)(buffer + pc));
+    const armcat_status_t status = disasm_instr(&disassembly->instructions[i], *(uint32_t *)(buffer + pc));
+    disassembly->valid[i >> 6] |= (uint64_t)(status == ARMCAT_STATUS_SUCCESS) << (i & 63);
 
     #ifdef ARMCAT_DEBUG
-      printf("[debug]: status: %d\n", disasm_instr(&disassembly->instructions[i], *(uint32_t *)(buffer + pc)));
+      printf("[debug]: status: %d\n", status);
     #endif
   }
 
   return disassembly;
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -19,19 +19,27 @@
 #ifndef __ARMCAT_H
 #define __ARMCAT_H
 
-#include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
-#include <string.h>
+
+#ifndef ARMCAT_FREESTANDING
+  #include <stdio.h>
+  #include <stdlib.h>
+  #include <string.h>
+#endif
 
 #include "instr.h"
 
 #define ARMCAT_INSTR_SIZEMAX 4 /* Maximum size of an ARM instruction. */
+#define ARMCAT_PAGE_SIZE     4096 /* Size of a page of code, the unit of caching and change detection. */
 
 /* ARMCAT disassembler API statuses. */
 #define ARMCAT_STATUS_SUCCESS  1
 #define ARMCAT_STATUS_FAILURE -1
 
+/* Macro that tests whether an instruction of a disassembly object was decoded successfully! */
+#define ARMCAT_INSTR_VALID(disassembly, i) (((disassembly)->valid[(i) >> 6] >> ((i) & 63)) & 1)
+
 
 /*
     *    src/armcat.h
@@ -45,9 +53,15 @@ typedef int armcat_status_t; /* Type-definition for int. */
 typedef struct _armcat_disasm {
   size_t ninstr; /* The amount of instructions. */
   armcat_instr_t *instructions; /* A dynamically-allocated array of structs containing the disassembly data. */
+  uint64_t *valid; /* A bitmap of the instructions that were decoded successfully. */
 } armcat_disasm_t;
 
-void armcat_free(armcat_disasm_t *disassembly);
-armcat_disasm_t *armcat_disasm(const void *buffer, const size_t nbytes);
+size_t armcat_disasm_into(const void *buffer, const size_t nbytes, armcat_instr_t *instructions,
+  const size_t capacity);
+
+#ifndef ARMCAT_FREESTANDING
+  void armcat_free(armcat_disasm_t *disassembly);
+  armcat_disasm_t *armcat_disasm(const void *buffer, const size_t nbytes);
+#endif
 
 #endif
\ No newline at end of file
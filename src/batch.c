@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "batch.h"
+#include "decode.h"
+#include "disasm.h"
+
+
+/*
+    *    src/batch.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Looks up the mnemonic of an opcode identifier produced by armcat_disasm_batch.
+ * @param opcode The opcode identifier.
+ * @returns The mnemonic, or NULL if the identifier is invalid.
+ */
+
+const char *armcat_opcode_mnemonic(const uint16_t opcode) {
+  if (opcode >= ARMCAT_OPCODE_TABLE_SIZE)
+    return NULL;
+
+  return ARMCAT_MNEMONIC(&opcode_table[opcode]);
+}
+
+/**
+ * @brief Extracts the generic operand fields of an instruction.
+ * @param fields The ARMCAT_BATCH_FIELDS fields that receive the operands.
+ * @param instr The encoded instruction.
+ */
+
+static inline __always_inline void batch_operand_fields(uint32_t *fields, const uint32_t instr) {
+  fields[ARMCAT_BATCH_FIELD_CODE] = ARMCAT_CONDITION_CODE_DECODE(instr);
+  fields[ARMCAT_BATCH_FIELD_SRC]  = ARMCAT_SRCREG_DECODE(instr);
+  fields[ARMCAT_BATCH_FIELD_DST]  = ARMCAT_DSTREG_DECODE(instr);
+
+  fields[ARMCAT_BATCH_FIELD_OPERAND] = ARMCAT_BRANCH_IMMEDIATE_DECODE(instr) 
+    ? ARMCAT_OPERAND_EXTEND(instr, 24) : ARMCAT_OPERAND_DECODE(instr);
+}
+
+/**
+ * @brief Disassembles a given buffer into caller-supplied flat arrays, stopping early once any array is full.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @param batch The arrays that receive the disassembly data.
+ * @returns The amount of bytes consumed from the buffer, the caller resumes from there.
+ */
+
+size_t armcat_disasm_batch(const void *buffer, const size_t nbytes, armcat_batch_t *batch) {
+  armcat_instr_t instr = {0};
+
+  batch->ninstr = batch->text_size = 0;
+
+  for (size_t pc = 0; pc + ARMCAT_INSTR_SIZEMAX <= nbytes && batch->ninstr < batch->capacity; pc += ARMCAT_INSTR_SIZEMAX) {
+    const size_t i = batch->ninstr;
+
+    memset(instr.disasm_instr, 0, sizeof(instr.disasm_instr));
+
+    const armcat_opcode_table_t *info = NULL;
+    const armcat_status_t status = disasm_instr_opcode(&instr, *(uint32_t *)(buffer + pc), &info);
+
+    if (batch->text && batch->text_capacity) {
+      size_t length = strlen(instr.disasm_instr);
+
+      /* Stop before a line that does not fit, unless it is the first one, which is truncated so the call progresses. */
+      if (batch->text_size + length + 1 > batch->text_capacity) {
+        if (i)
+          break;
+
+        length = batch->text_capacity - 1;
+      }
+
+      memcpy(&batch->text[batch->text_size], instr.disasm_instr, length);
+      batch->text[(batch->text_size += length + 1) - 1] = '\n';
+    }
+
+    if (batch->encodings)
+      batch->encodings[i] = instr.instr;
+    if (batch->opcodes)
+      batch->opcodes[i] = info ? (uint16_t)(info - opcode_table) : ARMCAT_BATCH_OPCODE_NONE;
+    if (batch->operands)
+      batch_operand_fields(&batch->operands[i * ARMCAT_BATCH_FIELDS], instr.instr);
+    if (batch->statuses)
+      batch->statuses[i] = (int8_t)status;
+    if (batch->rmasks)
+      batch->rmasks[i] = instr.rmask;
+    if (batch->wmasks)
+      batch->wmasks[i] = instr.wmask;
+    if (batch->flags)
+      batch->flags[i] = instr.flags;
+
+    batch->ninstr++;
+  }
+
+  return batch->ninstr * ARMCAT_INSTR_SIZEMAX;
+}
\ No newline at end of file
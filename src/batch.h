@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __BATCH_H
+#define __BATCH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_BATCH_FIELDS 4 /* Amount of operand fields stored per instruction. */
+
+/* Indices of the operand fields of an instruction! */
+#define ARMCAT_BATCH_FIELD_CODE    0 /* The condition code. */
+#define ARMCAT_BATCH_FIELD_SRC     1 /* The source register. (bits 19:16) */
+#define ARMCAT_BATCH_FIELD_DST     2 /* The destination register. (bits 15:12) */
+#define ARMCAT_BATCH_FIELD_OPERAND 3 /* The operand, the sign-extended word offset for immediate branches. */
+
+#define ARMCAT_BATCH_OPCODE_NONE 0xFFFF /* Opcode identifier of an encoding not named by the opcode table. */
+
+
+/*
+    *    src/batch.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Caller-supplied flat arrays that receive the disassembly of a buffer, any array may be NULL. */
+typedef struct _armcat_batch {
+  uint32_t *encodings; /* The encoded instructions. */
+  uint16_t *opcodes; /* Indices of the opcode table entry the mnemonic came from. (ARMCAT_BATCH_OPCODE_NONE if none) */
+  uint32_t *operands; /* ARMCAT_BATCH_FIELDS operand fields per instruction. */
+  int8_t *statuses; /* The armcat_status_t of each instruction. */
+  uint16_t *rmasks; /* The registers read by each instruction. */
+  uint16_t *wmasks; /* The registers written by each instruction. */
+  uint32_t *flags; /* The semantic flags of each instruction. */
+  char *text; /* The newline-delimited disassembly, one line per instruction. */
+  size_t capacity; /* The amount of instructions each array can hold. */
+  size_t text_capacity; /* The size of the text buffer, a first line that does not fit is truncated. */
+  size_t ninstr; /* The amount of instructions written. (output) */
+  size_t text_size; /* The amount of bytes written to the text buffer. (output) */
+} armcat_batch_t;
+
+const char *armcat_opcode_mnemonic(const uint16_t opcode);
+size_t armcat_disasm_batch(const void *buffer, const size_t nbytes, armcat_batch_t *batch);
+
+#endif
\ No newline at end of file
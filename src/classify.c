@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "classify.h"
+#include "decode.h"
+#include "disasm.h"
+
+
+/*
+    *    src/classify.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Scores how strongly a single word looks like data rather than code.
+ * @param disassembly The disassembly object.
+ * @param i The index of the word.
+ * @returns The evidence score, positive for data and negative for code.
+ */
+
+static inline __always_inline int classify_score(const armcat_disasm_t *disassembly, const size_t i) {
+  const armcat_instr_t *instr = &disassembly->instructions[i];
+
+  if (!ARMCAT_INSTR_VALID(disassembly, i))
+    return ARMCAT_CLASSIFY_SCORE_INVALID;
+
+  if (ARMCAT_CONDITION_CODE_DECODE(instr->instr) == ARMCAT_CONDITION_CODE_UNCONDITIONAL 
+    && !ARMCAT_BRANCH_IMMEDIATE_DECODE(instr->instr))
+    return ARMCAT_CLASSIFY_SCORE_UNCONDITIONAL;
+
+  if (ARMCAT_BRANCH_IMMEDIATE_DECODE(instr->instr)) {
+    /* The target is relative to the instruction address plus 8, as pc reads ahead two instructions. */
+    const int64_t target = (int64_t)(i + 2) + (int32_t)ARMCAT_OPERAND_EXTEND(instr->instr, 24);
+
+    if (target < 0 || target >= (int64_t)disassembly->ninstr)
+      return ARMCAT_CLASSIFY_SCORE_BRANCH_TARGET;
+  }
+
+  return ARMCAT_CLASSIFY_SCORE_CODE;
+}
+
+/**
+ * @brief Marks the word referenced by a pc-relative load as a literal pool entry.
+ * @param disassembly The disassembly object.
+ * @param classes The classes of each word.
+ * @param i The index of the load instruction.
+ */
+
+static inline __always_inline void classify_literal(const armcat_disasm_t *disassembly, uint8_t *classes,
+  const size_t i)
+{
+  const uint32_t instr = disassembly->instructions[i].instr;
+
+  /* Only immediate-offset loads (bits 27:25 == 010) from pc address a literal. */
+  if (ARMCAT_PARSE_BITS(instr, 25, 27) != 0x2 || !ARMCAT_LDRSTR_BIT_DECODE(instr) 
+    || ARMCAT_SRCREG_DECODE(instr) != 15)
+    return;
+
+  const int64_t offset = ARMCAT_PARSE_BITS(instr, 0, 11);
+  const int64_t target = (int64_t)(i * ARMCAT_INSTR_SIZEMAX + 8) 
+    + (ARMCAT_LDRSTR_UPDOWN_BIT_DECODE(instr) ? offset : -offset);
+
+  if (target >= 0 && target / ARMCAT_INSTR_SIZEMAX < (int64_t)disassembly->ninstr)
+    classes[target / ARMCAT_INSTR_SIZEMAX] = ARMCAT_CLASS_LITERAL;
+}
+
+/**
+ * @brief Classifies each word of a disassembly as probable code, data or literal pool entry.
+ * @param disassembly The disassembly object.
+ * @param classes An array of disassembly->ninstr entries that receives the classes. (ARMCAT_CLASS_*)
+ * @returns ARMCAT_STATUS_SUCCESS if the disassembly could be classified, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+armcat_status_t armcat_classify(const armcat_disasm_t *disassembly, uint8_t *classes) {
+  const size_t ninstr = disassembly->ninstr;
+
+  /* Prefix sums of the scores, so each window is scored in constant time. */
+  int64_t *scores = malloc((ninstr + 1) * sizeof(int64_t));
+  if (!scores)
+    return ARMCAT_STATUS_FAILURE;
+
+  scores[0] = 0;
+
+  for (size_t i = 0; i < ninstr; ++i) {
+    const int score = classify_score(disassembly, i);
+
+    scores[i + 1] = scores[i] + score;
+    classes[i] = (score >= ARMCAT_CLASSIFY_SCORE_THRESHOLD) ? ARMCAT_CLASS_DATA : ARMCAT_CLASS_CODE;
+  }
+
+  /* Words that decode on their own but are surrounded by data on both sides are data as well. */
+  for (size_t i = 0; i < ninstr; ++i) {
+    const size_t start = (i > ARMCAT_CLASSIFY_WINDOW) ? i - ARMCAT_CLASSIFY_WINDOW : 0;
+    const size_t end   = (i + ARMCAT_CLASSIFY_WINDOW + 1 < ninstr) ? i + ARMCAT_CLASSIFY_WINDOW + 1 : ninstr;
+
+    if (scores[i + 1] - scores[start] > 0 && scores[end] - scores[i] > 0)
+      classes[i] = ARMCAT_CLASS_DATA;
+  }
+
+  free(scores);
+
+  for (size_t i = 0; i < ninstr; ++i)
+    if (classes[i] == ARMCAT_CLASS_CODE && ARMCAT_INSTR_VALID(disassembly, i))
+      classify_literal(disassembly, classes, i);
+
+  return ARMCAT_STATUS_SUCCESS;
+}
\ No newline at end of file
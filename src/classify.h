@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __CLASSIFY_H
+#define __CLASSIFY_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+/* Classes of a disassembled word! */
+#define ARMCAT_CLASS_CODE    0 /* Probable code. */
+#define ARMCAT_CLASS_DATA    1 /* Probable data. */
+#define ARMCAT_CLASS_LITERAL 2 /* Literal pool entry, referenced by a pc-relative load. */
+
+#define ARMCAT_CLASSIFY_WINDOW 4 /* Amount of neighbouring words on each side that are scored together. */
+
+/* Evidence scores of a single word, positive scores point towards data! */
+#define ARMCAT_CLASSIFY_SCORE_CODE           -1 /* Decoded successfully. */
+#define ARMCAT_CLASSIFY_SCORE_INVALID         4 /* Could not be decoded. */
+#define ARMCAT_CLASSIFY_SCORE_UNCONDITIONAL   3 /* The 0xF condition field outside of an unconditional branch. */
+#define ARMCAT_CLASSIFY_SCORE_BRANCH_TARGET   1 /* Immediate branch whose target lies outside of the buffer, weak on its own. */
+#define ARMCAT_CLASSIFY_SCORE_THRESHOLD       3 /* Words scoring this much are data on their own. */
+
+
+/*
+    *    src/classify.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+armcat_status_t armcat_classify(const armcat_disasm_t *disassembly, uint8_t *classes);
+
+#endif
\ No newline at end of file
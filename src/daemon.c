@@ -0,0 +1,483 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+
+#include "hash.h"
+#include "daemon.h"
+#include "disasm.h"
+
+
+/*
+    *    src/daemon.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing a decoded page in the cache. */
+typedef struct _armcat_daemon_page {
+  uint64_t key; /* The hash of the page contents. */
+  size_t ninstr; /* The amount of instructions in the page. */
+  struct _armcat_daemon_page *prev; /* The more recently used page. */
+  struct _armcat_daemon_page *next; /* The less recently used page. */
+  struct _armcat_daemon_page *chain; /* The next page in the same bucket. */
+  uint32_t words[ARMCAT_DAEMON_PAGE_INSTR]; /* The page contents, compared on lookup. */
+  armcat_instr_t instructions[ARMCAT_DAEMON_PAGE_INSTR]; /* The disassembly data. */
+} armcat_daemon_page_t;
+
+/* Structure containing the LRU cache of decoded pages, keyed by content hash. */
+typedef struct _armcat_daemon_cache {
+  size_t npages; /* The amount of cached pages. */
+  size_t capacity; /* The maximum amount of cached pages. */
+  size_t nbuckets; /* The amount of hash buckets, a power of two. */
+  armcat_daemon_page_t **buckets; /* The hash buckets. */
+  armcat_daemon_page_t *head; /* The most recently used page. */
+  armcat_daemon_page_t *tail; /* The least recently used page. */
+  uint32_t words[ARMCAT_DAEMON_PAGE_INSTR]; /* The page being looked up, copied out of the client's memory. */
+} armcat_daemon_cache_t;
+
+/**
+ * @brief Unlinks a page from the recency list.
+ * @param cache The cache.
+ * @param page The page.
+ */
+
+static void daemon_cache_unlink(armcat_daemon_cache_t *cache, armcat_daemon_page_t *page) {
+  if (page->prev)
+    page->prev->next = page->next;
+  else
+    cache->head = page->next;
+
+  if (page->next)
+    page->next->prev = page->prev;
+  else
+    cache->tail = page->prev;
+}
+
+/**
+ * @brief Links a page at the front of the recency list.
+ * @param cache The cache.
+ * @param page The page.
+ */
+
+static void daemon_cache_push(armcat_daemon_cache_t *cache, armcat_daemon_page_t *page) {
+  page->prev = NULL;
+  page->next = cache->head;
+
+  if (cache->head)
+    cache->head->prev = page;
+  else
+    cache->tail = page;
+
+  cache->head = page;
+}
+
+/**
+ * @brief Looks a page up in the cache, decoding and inserting it on a miss.
+ * @param cache The cache.
+ * @param words The page contents.
+ * @param ninstr The amount of instructions in the page.
+ * @returns The cached page, NULL on failure.
+ */
+
+static armcat_daemon_page_t *daemon_cache_get(armcat_daemon_cache_t *cache, const uint32_t *words,
+  const size_t ninstr)
+{
+  /* The client can still write to its memory, so the page is hashed, compared and decoded from one private copy. */
+  memcpy(cache->words, words, ninstr * ARMCAT_INSTR_SIZEMAX);
+  words = cache->words;
+
+  const uint64_t key = hash_buffer(words, ninstr * ARMCAT_INSTR_SIZEMAX, 0);
+  armcat_daemon_page_t **bucket = &cache->buckets[key & (cache->nbuckets - 1)], *page = *bucket;
+
+  for (; page; page = page->chain)
+    if (page->key == key && page->ninstr == ninstr && !memcmp(page->words, words, ninstr * ARMCAT_INSTR_SIZEMAX)) {
+      daemon_cache_unlink(cache, page);
+      daemon_cache_push(cache, page);
+
+      return page;
+    }
+
+  if (cache->npages < cache->capacity) {
+    if (!(page = malloc(sizeof(armcat_daemon_page_t))))
+      return NULL;
+
+    cache->npages++;
+  }
+  else {
+    /* Recycle the least recently used page. */
+    page = cache->tail;
+
+    armcat_daemon_page_t **link = &cache->buckets[page->key & (cache->nbuckets - 1)];
+    while (*link != page)
+      link = &(*link)->chain;
+
+    *link = page->chain;
+    daemon_cache_unlink(cache, page);
+  }
+
+  page->key    = key;
+  page->ninstr = ninstr;
+  page->chain  = *bucket;
+
+  memcpy(page->words, words, ninstr * ARMCAT_INSTR_SIZEMAX);
+  memset(page->instructions, 0, ninstr * sizeof(armcat_instr_t));
+
+  for (size_t i = 0; i < ninstr; ++i)
+    disasm_instr(&page->instructions[i], words[i]);
+
+  *bucket = page;
+  daemon_cache_push(cache, page);
+
+  return page;
+}
+
+/**
+ * @brief Sends a message over the socket, optionally passing a file descriptor along.
+ * @param sock The socket.
+ * @param msg The message.
+ * @param fd The file descriptor, -1 for none.
+ * @returns ARMCAT_STATUS_SUCCESS if the message was sent, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static armcat_status_t daemon_send(const int sock, const armcat_daemon_msg_t *msg, const int fd) {
+  char control[CMSG_SPACE(sizeof(int))] = {0};
+
+  struct iovec iov = { .iov_base = (void *)msg, .iov_len = sizeof(armcat_daemon_msg_t) };
+  struct msghdr header = { .msg_iov = &iov, .msg_iovlen = 1 };
+
+  if (fd >= 0) {
+    header.msg_control    = control;
+    header.msg_controllen = sizeof(control);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header);
+
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type  = SCM_RIGHTS;
+    cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  }
+
+  return (sendmsg(sock, &header, MSG_NOSIGNAL) == sizeof(armcat_daemon_msg_t)) 
+    ? ARMCAT_STATUS_SUCCESS : ARMCAT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Receives a message from the socket, along with the file descriptor passed with it.
+ * @param sock The socket.
+ * @param msg Receives the message.
+ * @param fd Receives the file descriptor, -1 if none was passed.
+ * @returns ARMCAT_STATUS_SUCCESS if a valid message was received, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static armcat_status_t daemon_recv(const int sock, armcat_daemon_msg_t *msg, int *fd) {
+  char control[CMSG_SPACE(sizeof(int))] = {0};
+
+  struct iovec iov = { .iov_base = msg, .iov_len = sizeof(armcat_daemon_msg_t) };
+  struct msghdr header = { .msg_iov = &iov, .msg_iovlen = 1, .msg_control = control, .msg_controllen = sizeof(control) };
+
+  *fd = -1;
+
+  if (recvmsg(sock, &header, MSG_CMSG_CLOEXEC) != sizeof(armcat_daemon_msg_t))
+    return ARMCAT_STATUS_FAILURE;
+
+  const struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header);
+  if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+    memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+
+  return (msg->magic == ARMCAT_DAEMON_MAGIC) ? ARMCAT_STATUS_SUCCESS : ARMCAT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Creates an anonymous shared memory file of a given size and maps it, sealed against shrinking.
+ * @param nbytes The size.
+ * @param fd Receives the file descriptor.
+ * @returns The writable mapping, NULL on failure.
+ */
+
+static void *daemon_shm_create(const size_t nbytes, int *fd) {
+  if ((*fd = memfd_create("armcat", MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0)
+    return NULL;
+
+  void *mapping = MAP_FAILED;
+
+  if (!nbytes || ftruncate(*fd, nbytes) || fcntl(*fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL)
+    || (mapping = mmap(NULL, nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0)) == MAP_FAILED)
+  {
+    close(*fd);
+
+    return NULL;
+  }
+
+  return mapping;
+}
+
+/**
+ * @brief Maps shared memory received from the peer, which must be sealed so it cannot shrink under the mapping.
+ * @param fd The file descriptor.
+ * @param nbytes The size the peer advertised.
+ * @returns The read-only mapping, NULL if the memory is unsealed, too small or could not be mapped.
+ */
+
+static const void *daemon_shm_map(const int fd, const size_t nbytes) {
+  struct stat info;
+
+  /* Without F_SEAL_SHRINK the peer could truncate the file after the check, faulting every later read. */
+  if (!nbytes || !(fcntl(fd, F_GET_SEALS) & F_SEAL_SHRINK) || fstat(fd, &info) || (uint64_t)info.st_size < nbytes)
+    return NULL;
+
+  const void *mapping = mmap(NULL, nbytes, PROT_READ, MAP_SHARED, fd, 0);
+
+  return (mapping != MAP_FAILED) ? mapping : NULL;
+}
+
+/**
+ * @brief Serves a single request, decoding the buffer page by page through the cache.
+ * @param cache The cache.
+ * @param sock The connected socket.
+ * @returns ARMCAT_STATUS_SUCCESS if the request was served, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static armcat_status_t daemon_handle(armcat_daemon_cache_t *cache, const int sock) {
+  armcat_daemon_msg_t request, reply = { .magic = ARMCAT_DAEMON_MAGIC, .status = ARMCAT_STATUS_FAILURE };
+  int input = -1, output = -1;
+
+  if (daemon_recv(sock, &request, &input) != ARMCAT_STATUS_SUCCESS || input < 0) {
+    if (input >= 0)
+      close(input);
+
+    return daemon_send(sock, &reply, -1);
+  }
+
+  const size_t ninstr = request.nbytes / ARMCAT_INSTR_SIZEMAX;
+
+  const uint32_t *words = daemon_shm_map(input, request.nbytes);
+  close(input);
+
+  if (!words)
+    return daemon_send(sock, &reply, -1);
+
+  armcat_instr_t *instructions = daemon_shm_create(ninstr * sizeof(armcat_instr_t), &output);
+
+  if (instructions) {
+    reply.status = ARMCAT_STATUS_SUCCESS;
+    reply.nbytes = ninstr * sizeof(armcat_instr_t);
+
+    for (size_t i = 0; i < ninstr && reply.status == ARMCAT_STATUS_SUCCESS; i += ARMCAT_DAEMON_PAGE_INSTR) {
+      const size_t count = (ninstr - i < ARMCAT_DAEMON_PAGE_INSTR) ? ninstr - i : ARMCAT_DAEMON_PAGE_INSTR;
+      const armcat_daemon_page_t *page = daemon_cache_get(cache, &words[i], count);
+
+      if (page)
+        memcpy(&instructions[i], page->instructions, count * sizeof(armcat_instr_t));
+      else
+        reply.status = ARMCAT_STATUS_FAILURE;
+    }
+
+    munmap(instructions, ninstr * sizeof(armcat_instr_t));
+  }
+
+  munmap((void *)words, request.nbytes);
+
+  const armcat_status_t status = daemon_send(sock, &reply, (reply.status == ARMCAT_STATUS_SUCCESS) ? output : -1);
+
+  if (output >= 0)
+    close(output);
+
+  return status;
+}
+
+/**
+ * @brief Creates the listening socket, only replacing a stale socket file left by a daemon that is gone.
+ * @param path The path of the socket.
+ * @returns The listening socket, -1 on failure.
+ */
+
+static int daemon_listen(const char *path) {
+  struct sockaddr_un address = { .sun_family = AF_UNIX };
+  struct stat info;
+
+  if (strlen(path) >= sizeof(address.sun_path))
+    return -1;
+
+  strcpy(address.sun_path, path);
+
+  const int server = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (server < 0)
+    return -1;
+
+  if (!lstat(path, &info)) {
+    /* Anything but a socket nobody answers on belongs to someone else. */
+    if (!S_ISSOCK(info.st_mode) || !connect(server, (struct sockaddr *)&address, sizeof(address))) {
+      close(server);
+
+      return -1;
+    }
+
+    unlink(path);
+  }
+
+  /* Only the owner may connect, the umask covers the window between bind and listen. */
+  const mode_t mask = umask(0077);
+  const int bound = bind(server, (struct sockaddr *)&address, sizeof(address));
+
+  umask(mask);
+
+  if (bound || listen(server, ARMCAT_DAEMON_BACKLOG)) {
+    close(server);
+
+    return -1;
+  }
+
+  return server;
+}
+
+/**
+ * @brief Serves disassembly requests on a Unix domain socket, until an unrecoverable error occurs.
+ * @param path The path of the socket.
+ * @param cache_pages The maximum amount of decoded pages kept in the cache. (0 for ARMCAT_DAEMON_CACHE_PAGES)
+ * @returns ARMCAT_STATUS_FAILURE if the socket could not be set up or accepted connections.
+ */
+
+armcat_status_t armcat_daemon_serve(const char *path, const size_t cache_pages) {
+  armcat_daemon_cache_t cache = { .capacity = cache_pages ? cache_pages : ARMCAT_DAEMON_CACHE_PAGES, .nbuckets = 1 };
+
+  while (cache.nbuckets < cache.capacity)
+    cache.nbuckets <<= 1;
+
+  if (!(cache.buckets = calloc(cache.nbuckets, sizeof(armcat_daemon_page_t *))))
+    return ARMCAT_STATUS_FAILURE;
+
+  const int server = daemon_listen(path);
+
+  if (server < 0) {
+    free(cache.buckets);
+    return ARMCAT_STATUS_FAILURE;
+  }
+
+  /* Requests are served one at a time, so a client that stalls is dropped after the timeout. */
+  const struct timeval timeout = { .tv_sec = ARMCAT_DAEMON_TIMEOUT_MS / 1000, .tv_usec = (ARMCAT_DAEMON_TIMEOUT_MS % 1000) * 1000 };
+
+  for (;;) {
+    const int client = accept4(server, NULL, NULL, SOCK_CLOEXEC);
+
+    if (client < 0) {
+      if (errno == EINTR || errno == ECONNABORTED)
+        continue;
+
+      break;
+    }
+
+    if (!setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout))
+      && !setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)))
+      daemon_handle(&cache, client);
+
+    close(client);
+  }
+
+  close(server);
+
+  while (cache.head) {
+    armcat_daemon_page_t *page = cache.head;
+
+    cache.head = page->next;
+    free(page);
+  }
+
+  free(cache.buckets);
+  return ARMCAT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Disassembles a given buffer through a running daemon.
+ * @param path The path of the daemon socket.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @returns A struct containing the disassembly data, NULL on failure.
+ */
+
+armcat_disasm_t *armcat_daemon_disasm(const char *path, const void *buffer, const size_t nbytes) {
+  struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+  const size_t ninstr = nbytes / ARMCAT_INSTR_SIZEMAX;
+
+  if (strlen(path) >= sizeof(address.sun_path) || !ninstr)
+    return NULL;
+
+  strcpy(address.sun_path, path);
+
+  int input = -1, output = -1;
+
+  void *shared = daemon_shm_create(ninstr * ARMCAT_INSTR_SIZEMAX, &input);
+  if (!shared)
+    return NULL;
+
+  memcpy(shared, buffer, ninstr * ARMCAT_INSTR_SIZEMAX);
+  munmap(shared, ninstr * ARMCAT_INSTR_SIZEMAX);
+
+  armcat_daemon_msg_t request = { .magic = ARMCAT_DAEMON_MAGIC, .nbytes = ninstr * ARMCAT_INSTR_SIZEMAX }, reply;
+  armcat_disasm_t *disassembly = NULL;
+
+  const int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+  if (sock >= 0 && !connect(sock, (struct sockaddr *)&address, sizeof(address))
+    && daemon_send(sock, &request, input) == ARMCAT_STATUS_SUCCESS
+    && daemon_recv(sock, &reply, &output) == ARMCAT_STATUS_SUCCESS
+    && reply.status == ARMCAT_STATUS_SUCCESS && output >= 0 && reply.nbytes == ninstr * sizeof(armcat_instr_t))
+  {
+    const armcat_instr_t *instructions = daemon_shm_map(output, reply.nbytes);
+
+    if (instructions && (disassembly = calloc(1, sizeof(armcat_disasm_t)))) {
+      disassembly->ninstr       = ninstr;
+      disassembly->instructions = malloc(reply.nbytes);
+      disassembly->valid        = calloc((ninstr + 63) / 64, sizeof(uint64_t));
+
+      if (disassembly->instructions && disassembly->valid) {
+        memcpy(disassembly->instructions, instructions, reply.nbytes);
+
+        for (size_t i = 0; i < ninstr; ++i)
+          disassembly->valid[i >> 6] |= (uint64_t)(instructions[i].status == ARMCAT_STATUS_SUCCESS) << (i & 63);
+      }
+      else {
+        armcat_free(disassembly);
+        disassembly = NULL;
+      }
+    }
+
+    if (instructions)
+      munmap((void *)instructions, reply.nbytes);
+  }
+
+  if (sock >= 0)
+    close(sock);
+  if (output >= 0)
+    close(output);
+
+  close(input);
+  return disassembly;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __DAEMON_H
+#define __DAEMON_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_DAEMON_MAGIC       0x41524D43 /* "ARMC", tags every request and reply. */
+#define ARMCAT_DAEMON_BACKLOG     64         /* Amount of pending connections the socket queues. */
+#define ARMCAT_DAEMON_CACHE_PAGES 4096       /* Default amount of decoded pages kept in the cache. */
+#define ARMCAT_DAEMON_TIMEOUT_MS  1000       /* Time a client may stall a send or receive before it is dropped. */
+
+#define ARMCAT_DAEMON_PAGE_INSTR (ARMCAT_PAGE_SIZE / ARMCAT_INSTR_SIZEMAX) /* Instructions per cached page. */
+
+
+/*
+    *    src/daemon.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure exchanged over the socket, the buffer itself travels as a shared memory file descriptor. */
+typedef struct _armcat_daemon_msg {
+  uint32_t magic; /* ARMCAT_DAEMON_MAGIC. */
+  int32_t status; /* The status of the reply. (ARMCAT_STATUS_*) */
+  uint64_t nbytes; /* The size of the buffer in a request, the size of the results in a reply. */
+} armcat_daemon_msg_t;
+
+armcat_status_t armcat_daemon_serve(const char *path, const size_t cache_pages);
+armcat_disasm_t *armcat_daemon_disasm(const char *path, const void *buffer, const size_t nbytes);
+
+#endif
\ No newline at end of file
@@ -27,90 +27,101 @@
 */
 
 
-/* Opcode table containing the mnemonic and group information. */
+/* Packed mnemonic table, indexed by armcat_mnemonic_t offsets so the opcode table holds no pointers! */
+const char opcode_mnemonics[] =
+  "adc\0and\0add\0bic\0mov\0mvn\0orr\0sub\0"
+  "cmp\0cmn\0rsb\0eor\0teq\0tst\0rsc\0sbc\0"
+  "ldr\0ldrt\0ldrb\0ldrbt\0str\0strt\0strb\0strbt\0"
+  "b\0bl\0bx\0svc\0clz\0nop\0rfe\0rfedb\0cps\0pli";
+
+/* Opcode table containing the mnemonic, group and semantic information. */
 const armcat_opcode_table_t opcode_table[ARMCAT_OPCODE_TABLE_SIZE] = {
-  {"adc", 0x0a, DATA_PROCESSING},
-  {"adc", 0x2a, DATA_PROCESSING},
-  {"and", 0x00, DATA_PROCESSING},
-  {"and", 0x20, DATA_PROCESSING},
-  {"add", 0x28, DATA_PROCESSING},
-  {"add", 0x08, DATA_PROCESSING},
-  {"bic", 0x3c, DATA_PROCESSING},
-  {"bic", 0x1c, DATA_PROCESSING},
-  {"mov", 0x3a, DATA_PROCESSING},
-  {"mov", 0x1a, DATA_PROCESSING},
-  {"mvn", 0x3e, DATA_PROCESSING},
-  {"mvn", 0x1e, DATA_PROCESSING},
-  {"orr", 0x38, DATA_PROCESSING},
-  {"orr", 0x18, DATA_PROCESSING},
-  {"sub", 0x24, DATA_PROCESSING},
-  {"sub", 0x04, DATA_PROCESSING},
-  {"cmp", 0x35, DATA_PROCESSING},
-  {"cmp", 0x15, DATA_PROCESSING},
-  {"cmn", 0x37, DATA_PROCESSING},
-  {"cmn", 0x17, DATA_PROCESSING},
-  {"rsb", 0x26, DATA_PROCESSING},
-  {"rsb", 0x06, DATA_PROCESSING},
-  {"eor", 0x22, DATA_PROCESSING},
-  {"eor", 0x02, DATA_PROCESSING},
-  {"teq", 0x33, DATA_PROCESSING},
-  {"teq", 0x13, DATA_PROCESSING},
-  {"tst", 0x31, DATA_PROCESSING},
-  {"tst", 0x11, DATA_PROCESSING},
-  {"rsc", 0x2e, DATA_PROCESSING},
-  {"rsc", 0x0e, DATA_PROCESSING},
-  {"sbc", 0x2c, DATA_PROCESSING},
-  {"sbc", 0x0c, DATA_PROCESSING},
-  {"ldr", 0x59, LOAD_STORE},
-  {"ldr", 0x79, LOAD_STORE},
-  {"ldrt", 0x4b, LOAD_STORE},
-  {"ldrb", 0x5d, LOAD_STORE},
-  {"ldrb", 0x7d, LOAD_STORE},
-  {"ldrbt", 0x4e, LOAD_STORE},
-  {"str", 0x52, LOAD_STORE},
-  {"str", 0x58, LOAD_STORE},
-  {"str", 0x78, LOAD_STORE},
-  {"strt", 0x4a, LOAD_STORE},
-  {"strb", 0x5c, LOAD_STORE},
-  {"strb", 0x7c, LOAD_STORE},
-  {"strbt", 0x4f, LOAD_STORE},
-  {"b", 0xa4, BRANCHING},
-  {"b", 0xa0, BRANCHING},
-  {"bl", 0xb0, BRANCHING},
-  {"bx", 0x12, BRANCHING},
-  {"svc", 0xf0, MISCELLANEOUS},
-  {"clz", 0x16, MISCELLANEOUS},
-  {"nop", 0x32, MISCELLANEOUS},
-  {"rfe", 0x89, MISCELLANEOUS},
-  {"rfedb", 0x91, MISCELLANEOUS},
-  {"cps", 0x10, MISCELLANEOUS},
-  {"pli", 0x4d, MISCELLANEOUS}
+  {ARMCAT_MNEMONIC_ADC, 0x0a, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_ADC, 0x2a, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_AND, 0x00, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_AND, 0x20, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_ADD, 0x28, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_ADD, 0x08, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_BIC, 0x3c, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_BIC, 0x1c, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_MOV, 0x3a, DATA_PROCESSING, ARMCAT_SEMANTICS_MOVE},
+  {ARMCAT_MNEMONIC_MOV, 0x1a, DATA_PROCESSING, ARMCAT_SEMANTICS_MOVE},
+  {ARMCAT_MNEMONIC_MVN, 0x3e, DATA_PROCESSING, ARMCAT_SEMANTICS_MOVE},
+  {ARMCAT_MNEMONIC_MVN, 0x1e, DATA_PROCESSING, ARMCAT_SEMANTICS_MOVE},
+  {ARMCAT_MNEMONIC_ORR, 0x38, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_ORR, 0x18, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_SUB, 0x24, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_SUB, 0x04, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_CMP, 0x35, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_CMP, 0x15, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_CMN, 0x37, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_CMN, 0x17, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_RSB, 0x26, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_RSB, 0x06, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_EOR, 0x22, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_EOR, 0x02, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_TEQ, 0x33, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_TEQ, 0x13, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_TST, 0x31, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_TST, 0x11, DATA_PROCESSING, ARMCAT_SEMANTICS_TEST},
+  {ARMCAT_MNEMONIC_RSC, 0x2e, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_RSC, 0x0e, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_SBC, 0x2c, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_SBC, 0x0c, DATA_PROCESSING, ARMCAT_SEMANTICS_ALU},
+  {ARMCAT_MNEMONIC_LDR, 0x59, LOAD_STORE, ARMCAT_SEMANTICS_LOAD},
+  {ARMCAT_MNEMONIC_LDR, 0x79, LOAD_STORE, ARMCAT_SEMANTICS_LOAD},
+  {ARMCAT_MNEMONIC_LDRT, 0x4b, LOAD_STORE, ARMCAT_SEMANTICS_LOAD},
+  {ARMCAT_MNEMONIC_LDRB, 0x5d, LOAD_STORE, ARMCAT_SEMANTICS_LOAD},
+  {ARMCAT_MNEMONIC_LDRB, 0x7d, LOAD_STORE, ARMCAT_SEMANTICS_LOAD},
+  {ARMCAT_MNEMONIC_LDRBT, 0x4e, LOAD_STORE, ARMCAT_SEMANTICS_LOAD},
+  {ARMCAT_MNEMONIC_STR, 0x52, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_STR, 0x58, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_STR, 0x78, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_STRT, 0x4a, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_STRB, 0x5c, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_STRB, 0x7c, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_STRBT, 0x4f, LOAD_STORE, ARMCAT_SEMANTICS_STORE},
+  {ARMCAT_MNEMONIC_B, 0xa4, BRANCHING, ARMCAT_SEMANTICS_JUMP},
+  {ARMCAT_MNEMONIC_B, 0xa0, BRANCHING, ARMCAT_SEMANTICS_JUMP},
+  {ARMCAT_MNEMONIC_BL, 0xb0, BRANCHING, ARMCAT_SEMANTICS_CALL},
+  {ARMCAT_MNEMONIC_BX, 0x12, BRANCHING, ARMCAT_SEMANTICS_JUMP},
+  {ARMCAT_MNEMONIC_SVC, 0xf0, MISCELLANEOUS, 0},
+  {ARMCAT_MNEMONIC_CLZ, 0x16, MISCELLANEOUS, ARMCAT_SEMANTICS_MOVE},
+  {ARMCAT_MNEMONIC_NOP, 0x32, MISCELLANEOUS, 0},
+  {ARMCAT_MNEMONIC_RFE, 0x89, MISCELLANEOUS, ARMCAT_SEMANTICS_RETURN},
+  {ARMCAT_MNEMONIC_RFEDB, 0x91, MISCELLANEOUS, ARMCAT_SEMANTICS_RETURN},
+  {ARMCAT_MNEMONIC_CPS, 0x10, MISCELLANEOUS, 0},
+  {ARMCAT_MNEMONIC_PLI, 0x4d, MISCELLANEOUS, ARMCAT_SEMANTIC_READS_RN}
 };
 
 /**
  * @brief Decodes MUL/MLA instructions.
+ * @param decoded The structure that receives the decoded instruction attributes.
  * @param instr The instruction.
  * @returns A structure containing the decoded instruction attributes.
  */
 
-armcat_mul_instr_t *decode_mul_instr(const uint32_t instr) {
-  return &(armcat_mul_instr_t) {
+armcat_mul_instr_t *decode_mul_instr(armcat_mul_instr_t *decoded, const uint32_t instr) {
+  *decoded = (armcat_mul_instr_t) {
     .src     = ARMCAT_MUL_SRCREG_DECODE(instr),
     .dst     = ARMCAT_MUL_DSTREG_DECODE(instr),
     .code    = ARMCAT_CONDITION_CODE_DECODE(instr),
     .type    = ARMCAT_MUL_BIT_DECODE(instr),
     .operand = ARMCAT_MUL_OPERAND_DECODE(instr)
   };
+
+  return decoded;
 }
 
 /**
  * @brief Decodes data-processing instructions.
+ * @param decoded The structure that receives the decoded instruction attributes.
  * @param instr The instruction.
  * @returns A structure containing the decoded instruction attributes.
  */
 
-armcat_data_instr_t *decode_data_instr(const uint32_t instr) {
-  return &(armcat_data_instr_t) {
+armcat_data_instr_t *decode_data_instr(armcat_data_instr_t *decoded, const uint32_t instr) {
+  *decoded = (armcat_data_instr_t) {
     .src     = ARMCAT_SRCREG_DECODE(instr),
     .dst     = ARMCAT_DSTREG_DECODE(instr),
     .rot     = ARMCAT_DATAINSTR_ROT_DECODE(instr),
@@ -118,16 +129,19 @@ armcat_data_instr_t *decode_data_instr(const uint32_t instr) {
     .type    = ARMCAT_DATAINSTR_IMM_OPERAND_DECODE(instr),
     .operand = ARMCAT_OPERAND_DECODE(instr)
   };
+
+  return decoded;
 }
 
 /**
  * @brief Decodes miscellaneous instructions.
+ * @param decoded The structure that receives the decoded instruction attributes.
  * @param instr The instruction.
  * @returns A structure containing the decoded instruction attributes.
  */
 
-armcat_misc_instr_t *decode_misc_instr(const uint32_t instr) {
-  return &(armcat_misc_instr_t) {
+armcat_misc_instr_t *decode_misc_instr(armcat_misc_instr_t *decoded, const uint32_t instr) {
+  *decoded = (armcat_misc_instr_t) {
     .src      = ARMCAT_SRCREG_DECODE(instr),
     .dst      = ARMCAT_DSTREG_DECODE(instr),
     .code     = ARMCAT_CONDITION_CODE_DECODE(instr),
@@ -137,16 +151,19 @@ armcat_misc_instr_t *decode_misc_instr(const uint32_t instr) {
     .operand  = ARMCAT_OPERAND_DECODE(instr),
     .moperand = ARMCAT_MISC_REGISTER_DECODE(instr)
   };
+
+  return decoded;
 }
 
 /**
  * @brief Decodes branching instructions.
+ * @param decoded The structure that receives the decoded instruction attributes.
  * @param instr The instruction.
  * @returns A structure containing the decoded instruction attributes.
  */
 
-armcat_branch_instr_t *decode_branch_instr(const uint32_t instr) {
-  return &(armcat_branch_instr_t) {
+armcat_branch_instr_t *decode_branch_instr(armcat_branch_instr_t *decoded, const uint32_t instr) {
+  *decoded = (armcat_branch_instr_t) {
     .src     = ARMCAT_SRCREG_DECODE(instr),
     .dst     = ARMCAT_DSTREG_DECODE(instr),
     .code    = ARMCAT_CONDITION_CODE_DECODE(instr),
@@ -154,16 +171,19 @@ armcat_branch_instr_t *decode_branch_instr(const uint32_t instr) {
     .opcode  = ARMCAT_BRANCHING_OPCODE_DECODE(instr),
     .operand = ARMCAT_MISC_REGISTER_DECODE(instr)
   };
+
+  return decoded;
 }
 
 /**
  * @brief Decodes load/store instructions.
+ * @param decoded The structure that receives the decoded instruction attributes.
  * @param instr The instruction.
  * @returns A structure containing the decoded instruction attributes.
  */
 
-armcat_ldrstr_instr_t *decode_ldrstr_instr(const uint32_t instr) {
-  return &(armcat_ldrstr_instr_t) {
+armcat_ldrstr_instr_t *decode_ldrstr_instr(armcat_ldrstr_instr_t *decoded, const uint32_t instr) {
+  *decoded = (armcat_ldrstr_instr_t) {
     .src       = ARMCAT_SRCREG_DECODE(instr),
     .dst       = ARMCAT_DSTREG_DECODE(instr),
     .code      = ARMCAT_CONDITION_CODE_DECODE(instr),
@@ -174,6 +194,8 @@ armcat_ldrstr_instr_t *decode_ldrstr_instr(const uint32_t instr) {
     .operand   = ARMCAT_OPERAND_DECODE(instr),
     .immediate = ARMCAT_LDRSTR_IMMEDIATE_DECODE(instr),
   };
+
+  return decoded;
 }
 
 /**
@@ -190,4 +212,37 @@ const armcat_opcode_table_t *decode_opcode(const uint32_t instr) {
       return &opcode_table[i];
 
   return NULL;
+}
+
+/**
+ * @brief Derives the register masks and semantic flags of a decoded instruction.
+ * @param instr A structure containing the decoded instruction attributes.
+ * @param semantics The semantic flags and operand roles of the instruction.
+ * @param rmask Registers read by the instruction besides its operand roles.
+ * @param wmask Registers written by the instruction besides its operand roles.
+ */
+
+void decode_semantics(armcat_instr_t *instr, const uint32_t semantics, 
+  uint16_t rmask, uint16_t wmask)
+{
+  if (semantics & ARMCAT_SEMANTIC_READS_RN)
+    rmask |= ARMCAT_REGISTER_BIT(ARMCAT_SRCREG_DECODE(instr->instr));
+  if (semantics & ARMCAT_SEMANTIC_READS_RD)
+    rmask |= ARMCAT_REGISTER_BIT(ARMCAT_DSTREG_DECODE(instr->instr));
+  if (semantics & ARMCAT_SEMANTIC_WRITES_RD)
+    wmask |= ARMCAT_REGISTER_BIT(ARMCAT_DSTREG_DECODE(instr->instr));
+
+  if (semantics & ARMCAT_SEMANTIC_WRITES_PC)
+    wmask |= ARMCAT_REGISTER_BIT(15);
+  if (semantics & ARMCAT_SEMANTIC_LINK)
+    wmask |= ARMCAT_REGISTER_BIT(14);
+
+  instr->rmask = rmask;
+  instr->wmask = wmask;
+  instr->flags = semantics & 0x000000FF;
+
+  if (wmask & ARMCAT_REGISTER_BIT(15))
+    instr->flags |= (ARMCAT_SEMANTIC_BRANCH | ARMCAT_SEMANTIC_WRITES_PC);
+  if (ARMCAT_CONDITION_CODE_DECODE(instr->instr) < ARMCAT_CONDITION_CODE_AL)
+    instr->flags |= ARMCAT_SEMANTIC_CONDITIONAL;
 }
\ No newline at end of file
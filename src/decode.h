@@ -19,21 +19,26 @@
 #ifndef __DECODE_H
 #define __DECODE_H
 
-#include <stdio.h>
 #include <stdint.h>
 
 #include "instr.h"
 
 #define ARMCAT_OPCODE_TABLE_SIZE 56 /* Size of opcode table! */
 
-#define ARMCAT_REGISTERS_AMOUNTMAX       17 /* Maximum amount of registers! */
+#define ARMCAT_REGISTERS_AMOUNTMAX       16 /* Maximum amount of registers! */
 #define ARMCAT_CONDITION_CODES_AMOUNTMAX 16 /* Maximum amount of condition codes! */
 
+/* Macros that look names up in the packed string tables, each entry is NUL-terminated and found by its offset! */
+#define ARMCAT_CONDITION_NAME(code) (&condition_codes[(code) * 3])
+#define ARMCAT_REGISTER_NAME(reg)   (&registers[(reg) * 3])
+#define ARMCAT_MNEMONIC(info)       (&opcode_mnemonics[(info)->mnemonic])
+
 /* Macro that parses bits from <start> to <end>! */
 #define ARMCAT_PARSE_BITS(instr, offset, end) (((uint32_t)(instr) << (31u - (end))) >> ((offset) + 31u - (end)))
 
 /* Macros for decoding generic instruction attributes. */
 #define ARMCAT_OPERAND_DECODE(encoded)             (encoded & 0x000000FF)
+#define ARMCAT_OPERAND_REGISTER_DECODE(operand)    (operand & 0x0000000F) /* Rm, the shift above it is not printed. */
 #define ARMCAT_DSTREG_DECODE(encoded)              ((encoded & 0x0000F000) >> 12)
 #define ARMCAT_SRCREG_DECODE(encoded)              ((encoded & 0x000F0000) >> 16)
 #define ARMCAT_INSTR_ENCODING_TYPE_DECODE(encoded) ((encoded >> 20) & 0xFF)
@@ -42,6 +47,8 @@
 /* Macros for decoding data-processing instruction attributes. */
 #define ARMCAT_DATAINSTR_ROT_DECODE(encoded)         ((encoded & 0x00000F00) >> 8)
 #define ARMCAT_DATAINSTR_IMM_OPERAND_DECODE(encoded) ((encoded & 0x0F000000) >> 24)
+#define ARMCAT_DATAINSTR_REGSHIFT_DECODE(encoded)     ((encoded & 0x00000090) == 0x00000010) /* Rm is shifted by Rs. */
+#define ARMCAT_DATAINSTR_SHIFTREG_DECODE(encoded)     ((encoded & 0x00000F00) >> 8)
 
 /* Macro for decoding the register type for miscellaneous instructions. */
 #define ARMCAT_MISC_REGISTER_DECODE(encoded)      (encoded & 0xf)
@@ -49,6 +56,10 @@
 /* Macro for decoding the opcode type for branching instructions. */
 #define ARMCAT_BRANCHING_OPCODE_DECODE(encoded)   ARMCAT_PARSE_BITS(encoded, 4, 7)
 
+/* Macros for decoding immediate (B/BL/BLX) branch attributes. */
+#define ARMCAT_BRANCH_IMMEDIATE_DECODE(encoded) (ARMCAT_PARSE_BITS(encoded, 25, 27) == 0x5)
+#define ARMCAT_BRANCH_OFFSET_MASK               0x00FFFFFF
+
 /* Macros for decoding MUL/MLA instruction attributes. */
 #define ARMCAT_MUL_BIT_DECODE(encoded)     ((encoded & 0x00200000) >> 21)
 #define ARMCAT_MUL_DSTREG_DECODE(encoded)  ((encoded & 0x000F0000) >> 16)
@@ -61,6 +72,21 @@
 #define ARMCAT_LDRSTR_OFFSET_DECODE(encoded)     ((encoded << 20) >> 4)
 #define ARMCAT_LDRSTR_IMMEDIATE_DECODE(encoded)  ((encoded & 0x02000000) >> 25)
 #define ARMCAT_LDRSTR_UPDOWN_BIT_DECODE(encoded) ((encoded & 0x00800000) >> 23)
+#define ARMCAT_LDRSTR_PREINDEX_DECODE(encoded)   ((encoded & 0x01000000) >> 24)
+#define ARMCAT_LDRSTR_WRITEBACK_DECODE(encoded)  ((encoded & 0x00200000) >> 21)
+
+/* Macro for decoding the S (set condition flags) bit. */
+#define ARMCAT_SETFLAGS_BIT_DECODE(encoded) ((encoded & 0x00100000) >> 20)
+
+/* Semantic presets used by the opcode table! */
+#define ARMCAT_SEMANTICS_ALU    (ARMCAT_SEMANTIC_READS_RN | ARMCAT_SEMANTIC_WRITES_RD)
+#define ARMCAT_SEMANTICS_MOVE   (ARMCAT_SEMANTIC_WRITES_RD)
+#define ARMCAT_SEMANTICS_TEST   (ARMCAT_SEMANTIC_READS_RN)
+#define ARMCAT_SEMANTICS_LOAD   (ARMCAT_SEMANTIC_LOAD | ARMCAT_SEMANTIC_READS_RN | ARMCAT_SEMANTIC_WRITES_RD)
+#define ARMCAT_SEMANTICS_STORE  (ARMCAT_SEMANTIC_STORE | ARMCAT_SEMANTIC_READS_RN | ARMCAT_SEMANTIC_READS_RD)
+#define ARMCAT_SEMANTICS_JUMP   (ARMCAT_SEMANTIC_BRANCH | ARMCAT_SEMANTIC_WRITES_PC)
+#define ARMCAT_SEMANTICS_CALL   (ARMCAT_SEMANTICS_JUMP | ARMCAT_SEMANTIC_LINK)
+#define ARMCAT_SEMANTICS_RETURN (ARMCAT_SEMANTICS_JUMP | ARMCAT_SEMANTIC_LOAD | ARMCAT_SEMANTIC_READS_RN)
 
 
 /*
@@ -87,21 +113,69 @@ typedef enum _armcat_instr_group {
   DATA_PROCESSING
 } armcat_instr_group_t;
 
+/* Offsets of the mnemonics in the packed mnemonic table. */
+typedef enum _armcat_mnemonic {
+  ARMCAT_MNEMONIC_ADC   = 0,
+  ARMCAT_MNEMONIC_AND   = 4,
+  ARMCAT_MNEMONIC_ADD   = 8,
+  ARMCAT_MNEMONIC_BIC   = 12,
+  ARMCAT_MNEMONIC_MOV   = 16,
+  ARMCAT_MNEMONIC_MVN   = 20,
+  ARMCAT_MNEMONIC_ORR   = 24,
+  ARMCAT_MNEMONIC_SUB   = 28,
+  ARMCAT_MNEMONIC_CMP   = 32,
+  ARMCAT_MNEMONIC_CMN   = 36,
+  ARMCAT_MNEMONIC_RSB   = 40,
+  ARMCAT_MNEMONIC_EOR   = 44,
+  ARMCAT_MNEMONIC_TEQ   = 48,
+  ARMCAT_MNEMONIC_TST   = 52,
+  ARMCAT_MNEMONIC_RSC   = 56,
+  ARMCAT_MNEMONIC_SBC   = 60,
+  ARMCAT_MNEMONIC_LDR   = 64,
+  ARMCAT_MNEMONIC_LDRT  = 68,
+  ARMCAT_MNEMONIC_LDRB  = 73,
+  ARMCAT_MNEMONIC_LDRBT = 78,
+  ARMCAT_MNEMONIC_STR   = 84,
+  ARMCAT_MNEMONIC_STRT  = 88,
+  ARMCAT_MNEMONIC_STRB  = 93,
+  ARMCAT_MNEMONIC_STRBT = 98,
+  ARMCAT_MNEMONIC_B     = 104,
+  ARMCAT_MNEMONIC_BL    = 106,
+  ARMCAT_MNEMONIC_BX    = 109,
+  ARMCAT_MNEMONIC_SVC   = 112,
+  ARMCAT_MNEMONIC_CLZ   = 116,
+  ARMCAT_MNEMONIC_NOP   = 120,
+  ARMCAT_MNEMONIC_RFE   = 124,
+  ARMCAT_MNEMONIC_RFEDB = 128,
+  ARMCAT_MNEMONIC_CPS   = 134,
+  ARMCAT_MNEMONIC_PLI   = 138
+} armcat_mnemonic_t;
+
 /* The opcode table, each table entry will contain data related to a opcode. */
 typedef struct _armcat_opcode_table {
-  const char* restrict mnemonic; /* The mnemonic. */
+  const uint8_t mnemonic; /* The offset of the mnemonic in opcode_mnemonics. (armcat_mnemonic_t) */
   const armcat_opcode_t opcode; /* The opcode. */
   const armcat_instr_group_t group; /* The instruction group. */
+  const uint32_t semantics; /* The semantic flags and operand roles. (ARMCAT_SEMANTIC_*) */
 } armcat_opcode_table_t;
 
+extern const char condition_codes[];
+extern const char registers[];
+extern const char opcode_mnemonics[];
+
+extern const armcat_opcode_table_t opcode_table[ARMCAT_OPCODE_TABLE_SIZE];
+
 const armcat_opcode_table_t *decode_opcode(const uint32_t instr);
 
-armcat_mul_instr_t *decode_mul_instr(const uint32_t instr);
-armcat_data_instr_t *decode_data_instr(const uint32_t instr);
+void decode_semantics(armcat_instr_t *instr, const uint32_t semantics, 
+  uint16_t rmask, uint16_t wmask);
+
+armcat_mul_instr_t *decode_mul_instr(armcat_mul_instr_t *decoded, const uint32_t instr);
+armcat_data_instr_t *decode_data_instr(armcat_data_instr_t *decoded, const uint32_t instr);
 
-armcat_misc_instr_t *decode_misc_instr(const uint32_t instr);
+armcat_misc_instr_t *decode_misc_instr(armcat_misc_instr_t *decoded, const uint32_t instr);
 
-armcat_ldrstr_instr_t *decode_ldrstr_instr(const uint32_t instr);
-armcat_branch_instr_t *decode_branch_instr(const uint32_t instr);
+armcat_ldrstr_instr_t *decode_ldrstr_instr(armcat_ldrstr_instr_t *decoded, const uint32_t instr);
+armcat_branch_instr_t *decode_branch_instr(armcat_branch_instr_t *decoded, const uint32_t instr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "diff.h"
+#include "decode.h"
+#include "disasm.h"
+
+#define ARMCAT_DIFF_HASH_PRIME 0x100000001B3ull      /* Multiplier of the rolling hash. */
+#define ARMCAT_DIFF_HASH_MIX   0x9E3779B97F4A7C15ull /* Multiplier that spreads the rolling hash over the table. */
+
+
+/*
+    *    src/diff.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure describing the two buffers being compared. */
+typedef struct _armcat_diff_ctx {
+  const uint32_t *old_words; /* The words of the old buffer. */
+  const uint32_t *new_words; /* The words of the new buffer. */
+  size_t old_nwords; /* The amount of words in the old buffer. */
+  size_t new_nwords; /* The amount of words in the new buffer. */
+  uint32_t old_base; /* The address the old buffer is loaded at. */
+  uint32_t new_base; /* The address the new buffer is loaded at. */
+  uint64_t *keys; /* Window hashes of the realignment search table. */
+  uint32_t *positions; /* First old-buffer offset of each window hash. */
+  size_t table_size; /* The amount of slots in the realignment search table. */
+  uint32_t flags; /* The diff flags. (ARMCAT_DIFF_IGNORE_*) */
+} armcat_diff_ctx_t;
+
+/**
+ * @brief Normalizes an encoded instruction, masking out pc-relative offsets that shift when code moves.
+ * @param instr The encoded instruction.
+ * @returns The normalized instruction.
+ */
+
+static inline __always_inline uint32_t diff_normalize(const uint32_t instr) {
+  if (ARMCAT_BRANCH_IMMEDIATE_DECODE(instr))
+    return instr & ~ARMCAT_BRANCH_OFFSET_MASK;
+
+  /* Immediate-offset loads/stores relative to pc. */
+  if (ARMCAT_PARSE_BITS(instr, 25, 27) == 0x2 && ARMCAT_SRCREG_DECODE(instr) == 15)
+    return instr & ~0x00000FFFu;
+
+  return instr;
+}
+
+/**
+ * @brief Hashes a window of normalized words.
+ * @param words The words.
+ * @returns The hash of the first ARMCAT_DIFF_WINDOW words.
+ */
+
+static inline __always_inline uint64_t diff_hash(const uint32_t *words) {
+  uint64_t hash = 0;
+
+  for (size_t i = 0; i < ARMCAT_DIFF_WINDOW; ++i)
+    hash = hash * ARMCAT_DIFF_HASH_PRIME + diff_normalize(words[i]);
+
+  return hash;
+}
+
+/**
+ * @brief Rolls a window hash forward by one word.
+ * @param hash The hash of the window starting at words[0].
+ * @param words The words.
+ * @param power ARMCAT_DIFF_HASH_PRIME raised to ARMCAT_DIFF_WINDOW - 1.
+ * @returns The hash of the window starting at words[1].
+ */
+
+static inline __always_inline uint64_t diff_roll(const uint64_t hash, const uint32_t *words, const uint64_t power) {
+  return (hash - diff_normalize(words[0]) * power) * ARMCAT_DIFF_HASH_PRIME + diff_normalize(words[ARMCAT_DIFF_WINDOW]);
+}
+
+/**
+ * @brief Compares two windows of normalized words.
+ * @param a The first window.
+ * @param b The second window.
+ * @returns 1 if the windows match, 0 if otherwise.
+ */
+
+static inline __always_inline int diff_window_equal(const uint32_t *a, const uint32_t *b) {
+  for (size_t i = 0; i < ARMCAT_DIFF_WINDOW; ++i)
+    if (diff_normalize(a[i]) != diff_normalize(b[i]))
+      return 0;
+
+  return 1;
+}
+
+/**
+ * @brief Appends a difference to the diff object.
+ * @param diff The diff object.
+ * @param ctx The buffers being compared.
+ * @param type The type of difference.
+ * @param i The offset into the old buffer, in words.
+ * @param j The offset into the new buffer, in words.
+ * @returns ARMCAT_STATUS_SUCCESS if the difference was added, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static armcat_status_t diff_append(armcat_diff_t *diff, const armcat_diff_ctx_t *ctx, const uint32_t type,
+  const size_t i, const size_t j)
+{
+  if (diff->nentries == diff->capacity) {
+    const size_t capacity = diff->capacity ? diff->capacity * 2 : 64;
+
+    armcat_diff_entry_t *entries = realloc(diff->entries, capacity * sizeof(armcat_diff_entry_t));
+    if (!entries)
+      return ARMCAT_STATUS_FAILURE;
+
+    diff->entries  = entries;
+    diff->capacity = capacity;
+  }
+
+  armcat_diff_entry_t *entry = &diff->entries[diff->nentries++];
+
+  memset(entry, 0, sizeof(armcat_diff_entry_t));
+
+  entry->type        = type;
+  entry->old_address = ctx->old_base + i * ARMCAT_INSTR_SIZEMAX;
+  entry->new_address = ctx->new_base + j * ARMCAT_INSTR_SIZEMAX;
+
+  if (type != ARMCAT_DIFF_INSERTED)
+    disasm_instr(&entry->old_instr, ctx->old_words[i]);
+  if (type != ARMCAT_DIFF_DELETED)
+    disasm_instr(&entry->new_instr, ctx->new_words[j]);
+
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Appends a change for aligned words that only match once normalized, such as a retargeted branch.
+ * @param diff The diff object.
+ * @param ctx The buffers being compared.
+ * @param i The offset into the old buffer, in words.
+ * @param j The offset into the new buffer, in words.
+ * @returns ARMCAT_STATUS_SUCCESS if the words are identical, ignored or the change was added, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static inline __always_inline armcat_status_t diff_append_retargeted(armcat_diff_t *diff, const armcat_diff_ctx_t *ctx,
+  const size_t i, const size_t j)
+{
+  if (ctx->old_words[i] == ctx->new_words[j] || (ctx->flags & ARMCAT_DIFF_IGNORE_RELOCATION))
+    return ARMCAT_STATUS_SUCCESS;
+
+  return diff_append(diff, ctx, ARMCAT_DIFF_CHANGED, i, j);
+}
+
+/**
+ * @brief Appends a hunk of differing words, pairing them up as changes before reporting the rest.
+ * @param diff The diff object.
+ * @param ctx The buffers being compared.
+ * @param i The offset of the hunk in the old buffer, in words.
+ * @param old_count The amount of old words in the hunk.
+ * @param j The offset of the hunk in the new buffer, in words.
+ * @param new_count The amount of new words in the hunk.
+ * @returns ARMCAT_STATUS_SUCCESS if the hunk was added, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static armcat_status_t diff_append_hunk(armcat_diff_t *diff, const armcat_diff_ctx_t *ctx, size_t i,
+  const size_t old_count, size_t j, const size_t new_count)
+{
+  const size_t old_end = i + old_count, new_end = j + new_count;
+
+  for (; i < old_end && j < new_end; ++i, ++j)
+    if (diff_append(diff, ctx, ARMCAT_DIFF_CHANGED, i, j) != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+
+  for (; i < old_end; ++i)
+    if (diff_append(diff, ctx, ARMCAT_DIFF_DELETED, i, j) != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+
+  for (; j < new_end; ++j)
+    if (diff_append(diff, ctx, ARMCAT_DIFF_INSERTED, i, j) != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Searches for the closest point where both buffers match again.
+ * @param ctx The buffers being compared.
+ * @param i The offset of the mismatch in the old buffer, in words.
+ * @param j The offset of the mismatch in the new buffer, in words.
+ * @param limit The maximum distance to search, in words.
+ * @param old_skip Receives the amount of old words before the realignment point.
+ * @param new_skip Receives the amount of new words before the realignment point.
+ * @returns ARMCAT_STATUS_SUCCESS if a realignment point was found, ARMCAT_STATUS_FAILURE if otherwise.
+ */
+
+static armcat_status_t diff_realign(armcat_diff_ctx_t *ctx, const size_t i, const size_t j, const size_t limit,
+  size_t *old_skip, size_t *new_skip)
+{
+  const size_t old_span = (ctx->old_nwords - i >= ARMCAT_DIFF_WINDOW) 
+    ? ((ctx->old_nwords - i - ARMCAT_DIFF_WINDOW < limit) ? ctx->old_nwords - i - ARMCAT_DIFF_WINDOW + 1 : limit) : 0;
+  const size_t new_span = (ctx->new_nwords - j >= ARMCAT_DIFF_WINDOW) 
+    ? ((ctx->new_nwords - j - ARMCAT_DIFF_WINDOW < limit) ? ctx->new_nwords - j - ARMCAT_DIFF_WINDOW + 1 : limit) : 0;
+
+  if (!old_span || !new_span)
+    return ARMCAT_STATUS_FAILURE;
+
+  size_t table_size = 1;
+  while (table_size < 2 * old_span)
+    table_size <<= 1;
+
+  if (table_size > ctx->table_size) {
+    uint64_t *keys = realloc(ctx->keys, table_size * sizeof(uint64_t));
+    if (keys)
+      ctx->keys = keys;
+
+    uint32_t *positions = realloc(ctx->positions, table_size * sizeof(uint32_t));
+    if (positions)
+      ctx->positions = positions;
+
+    if (!keys || !positions)
+      return ARMCAT_STATUS_FAILURE;
+
+    ctx->table_size = table_size;
+  }
+
+  const int shift = 64 - __builtin_ctzll(table_size);
+  const size_t mask = table_size - 1;
+
+  uint64_t power = 1;
+  for (size_t k = 1; k < ARMCAT_DIFF_WINDOW; ++k)
+    power *= ARMCAT_DIFF_HASH_PRIME;
+
+  /* Slots are empty when their position is UINT32_MAX. */
+  memset(ctx->positions, 0xFF, table_size * sizeof(uint32_t));
+
+  uint64_t hash = diff_hash(&ctx->old_words[i]);
+
+  /* Index every window of the old buffer, keeping only the closest occurrence of each. */
+  for (size_t di = 0; di < old_span; ++di) {
+    size_t slot = table_size > 1 ? (size_t)((hash * ARMCAT_DIFF_HASH_MIX) >> shift) : 0;
+
+    while (ctx->positions[slot] != UINT32_MAX && ctx->keys[slot] != hash)
+      slot = (slot + 1) & mask;
+
+    if (ctx->positions[slot] == UINT32_MAX) {
+      ctx->keys[slot] = hash;
+      ctx->positions[slot] = di;
+    }
+
+    if (di + 1 < old_span)
+      hash = diff_roll(hash, &ctx->old_words[i + di], power);
+  }
+
+  size_t best = SIZE_MAX;
+
+  hash = diff_hash(&ctx->new_words[j]);
+
+  /* Walk the new buffer, keeping the realignment point that skips the fewest words overall. */
+  for (size_t dj = 0; dj < new_span && dj < best; ++dj) {
+    size_t slot = table_size > 1 ? (size_t)((hash * ARMCAT_DIFF_HASH_MIX) >> shift) : 0;
+
+    while (ctx->positions[slot] != UINT32_MAX && ctx->keys[slot] != hash)
+      slot = (slot + 1) & mask;
+
+    if (ctx->positions[slot] != UINT32_MAX) {
+      const size_t di = ctx->positions[slot];
+
+      if (di + dj < best && diff_window_equal(&ctx->old_words[i + di], &ctx->new_words[j + dj])) {
+        best = di + dj;
+
+        *old_skip = di;
+        *new_skip = dj;
+      }
+    }
+
+    if (dj + 1 < new_span)
+      hash = diff_roll(hash, &ctx->new_words[j + dj], power);
+  }
+
+  return (best != SIZE_MAX) ? ARMCAT_STATUS_SUCCESS : ARMCAT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the diff object.
+ * @param diff The diff object.
+ */
+
+void armcat_diff_free(armcat_diff_t *diff) {
+  free(diff->entries);
+  free(diff);
+}
+
+/**
+ * @brief Compares two buffers instruction by instruction, realigning them after insertions and deletions.
+ * @param old_buffer The old buffer.
+ * @param old_nbytes The size of the old buffer.
+ * @param old_base The address the old buffer is loaded at.
+ * @param new_buffer The new buffer.
+ * @param new_nbytes The size of the new buffer.
+ * @param new_base The address the new buffer is loaded at.
+ * @param flags The diff flags. (ARMCAT_DIFF_IGNORE_*)
+ * @returns A struct containing the differences, NULL on failure.
+ */
+
+armcat_diff_t *armcat_diff(const void *old_buffer, const size_t old_nbytes, const uint32_t old_base,
+  const void *new_buffer, const size_t new_nbytes, const uint32_t new_base, const uint32_t flags)
+{
+  armcat_diff_t *diff = calloc(1, sizeof(armcat_diff_t));
+  if (!diff)
+    return NULL;
+
+  armcat_diff_ctx_t ctx = {
+    .old_words  = old_buffer,
+    .new_words  = new_buffer,
+    .old_nwords = old_nbytes / ARMCAT_INSTR_SIZEMAX,
+    .new_nwords = new_nbytes / ARMCAT_INSTR_SIZEMAX,
+    .old_base   = old_base,
+    .new_base   = new_base,
+    .flags      = flags
+  };
+
+  size_t i = 0, j = 0, old_end = ctx.old_nwords, new_end = ctx.new_nwords, limit = ARMCAT_DIFF_SEARCH_MIN;
+  armcat_status_t status = ARMCAT_STATUS_SUCCESS;
+
+  /* The common suffix never needs to be searched, only checked for retargeted words at the end. */
+  while (old_end && new_end && diff_normalize(ctx.old_words[old_end - 1]) == diff_normalize(ctx.new_words[new_end - 1]))
+    --old_end, --new_end;
+
+  ctx.old_nwords = old_end;
+  ctx.new_nwords = new_end;
+
+  while (status == ARMCAT_STATUS_SUCCESS && i < old_end && j < new_end) {
+    /* Normalized words keep the buffers aligned, but a changed offset at an aligned position is still a change. */
+    if (ctx.old_words[i] == ctx.new_words[j] || diff_normalize(ctx.old_words[i]) == diff_normalize(ctx.new_words[j])) {
+      status = diff_append_retargeted(diff, &ctx, i++, j++);
+      continue;
+    }
+
+    size_t old_skip = 0, new_skip = 0;
+
+    while (diff_realign(&ctx, i, j, limit, &old_skip, &new_skip) != ARMCAT_STATUS_SUCCESS) {
+      if (limit >= ARMCAT_DIFF_SEARCH_MAX || (limit >= old_end - i && limit >= new_end - j)) {
+        /* Nothing realigns within reach, report the whole searched span and move past it. */
+        old_skip = (old_end - i < limit) ? old_end - i : limit;
+        new_skip = (new_end - j < limit) ? new_end - j : limit;
+        break;
+      }
+
+      limit *= 2;
+    }
+
+    status = diff_append_hunk(diff, &ctx, i, old_skip, j, new_skip);
+
+    i += old_skip;
+    j += new_skip;
+
+    /* Most hunks are small, so start each search small again. */
+    limit = ARMCAT_DIFF_SEARCH_MIN;
+  }
+
+  if (status == ARMCAT_STATUS_SUCCESS)
+    status = diff_append_hunk(diff, &ctx, i, old_end - i, j, new_end - j);
+
+  for (; status == ARMCAT_STATUS_SUCCESS && old_end < old_nbytes / ARMCAT_INSTR_SIZEMAX; ++old_end, ++new_end)
+    status = diff_append_retargeted(diff, &ctx, old_end, new_end);
+
+  free(ctx.keys);
+  free(ctx.positions);
+
+  if (status != ARMCAT_STATUS_SUCCESS) {
+    armcat_diff_free(diff);
+
+    return NULL;
+  }
+
+  return diff;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __DIFF_H
+#define __DIFF_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_DIFF_WINDOW     8         /* Amount of matching words needed to realign the two buffers. */
+#define ARMCAT_DIFF_SEARCH_MIN 64        /* Initial amount of words searched for a realignment point. */
+#define ARMCAT_DIFF_SEARCH_MAX (1 << 20) /* Maximum amount of words searched for a realignment point. */
+
+/* Types of a difference! */
+#define ARMCAT_DIFF_INSERTED 0 /* Only present in the new buffer. */
+#define ARMCAT_DIFF_DELETED  1 /* Only present in the old buffer. */
+#define ARMCAT_DIFF_CHANGED  2 /* Replaced by another instruction. */
+
+/* Flags of a diff! */
+#define ARMCAT_DIFF_IGNORE_RELOCATION 0x00000001 /* Do not report aligned words that only differ in a pc-relative offset. */
+
+
+/*
+    *    src/diff.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure describing a single differing instruction. */
+typedef struct _armcat_diff_entry {
+  uint32_t type; /* The type of difference. (ARMCAT_DIFF_*) */
+  uint32_t old_address; /* The address in the old buffer. (where the instruction was, or would have been) */
+  uint32_t new_address; /* The address in the new buffer. (where the instruction is, or would have been) */
+  armcat_instr_t old_instr; /* The old instruction, zeroed for insertions. */
+  armcat_instr_t new_instr; /* The new instruction, zeroed for deletions. */
+} armcat_diff_entry_t;
+
+/* Structure containing the differences between two buffers. */
+typedef struct _armcat_diff {
+  size_t nentries; /* The amount of differences. */
+  size_t capacity; /* The amount of differences that fit in the entries array. */
+  armcat_diff_entry_t *entries; /* A dynamically-allocated array of differences, in address order. */
+} armcat_diff_t;
+
+void armcat_diff_free(armcat_diff_t *diff);
+
+armcat_diff_t *armcat_diff(const void *old_buffer, const size_t old_nbytes, const uint32_t old_base,
+  const void *new_buffer, const size_t new_nbytes, const uint32_t new_base, const uint32_t flags);
+
+#endif
\ No newline at end of file
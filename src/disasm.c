@@ -16,6 +16,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <stdarg.h>
+
 #include "instr.h"
 #include "disasm.h"
 
@@ -27,15 +29,79 @@
 */
 
 
-/* ARM condition codes! */
-const char *condition_codes[ARMCAT_CONDITION_CODES_AMOUNTMAX] = {
-  "eq", "ne", "cs", "cc", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le", "", ""
-};
+/* ARM condition codes, packed three bytes apart! */
+const char condition_codes[ARMCAT_CONDITION_CODES_AMOUNTMAX * 3] = 
+  "eq\0ne\0cs\0cc\0mi\0pl\0vs\0vc\0hi\0ls\0ge\0lt\0gt\0le\0\0\0\0\0";
+
+/* ARM registers, packed three bytes apart! */
+const char registers[ARMCAT_REGISTERS_AMOUNTMAX * 3] = 
+  "r0\0r1\0r2\0r3\0r4\0r5\0r6\0r7\0r8\0sb\0sl\0fp\0ip\0sp\0lr\0pc";
+
+/**
+ * @brief Appends a character to a text buffer, dropping what does not fit.
+ * @param buffer The text buffer.
+ * @param length The length written so far, including dropped characters.
+ * @param c The character.
+ */
+
+static inline __always_inline void disasm_putc(char *buffer, size_t *length, const char c) {
+  if (*length < ARMCAT_DISASM_INSTR_SIZEMAX - 1)
+    buffer[*length] = c;
+
+  (*length)++;
+}
+
+/**
+ * @brief Formats an instruction, a minimal snprintf supporting only the %s, %d and %x conversions.
+ * @param buffer The text buffer, ARMCAT_DISASM_INSTR_SIZEMAX bytes and always NUL-terminated.
+ * @param format The format.
+ */
+
+static void disasm_printf(char *buffer, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+
+  size_t length = 0;
+
+  for (; *format; ++format) {
+    if (*format != '%') {
+      disasm_putc(buffer, &length, *format);
+      continue;
+    }
+
+    char digits[10];
+    size_t ndigits = 0;
+
+    switch (*++format) {
+      case 's':
+        for (const char *string = va_arg(args, const char *); *string; ++string)
+          disasm_putc(buffer, &length, *string);
+        break;
+      case 'd': {
+        const int value = va_arg(args, int);
+        uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+
+        if (value < 0)
+          disasm_putc(buffer, &length, '-');
 
-/* ARM registers! */
-const char *registers[ARMCAT_REGISTERS_AMOUNTMAX] = {
-  "r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "r8", "sb", "sl", "fp", "ip", "sp", "lr", "pc", "r16"
-};
+        do digits[ndigits++] = '0' + magnitude % 10; while (magnitude /= 10);
+        break;
+      }
+      case 'x': {
+        uint32_t value = va_arg(args, uint32_t);
+
+        do digits[ndigits++] = "0123456789abcdef"[value & 0xf]; while (value >>= 4);
+        break;
+      }
+    }
+
+    while (ndigits)
+      disasm_putc(buffer, &length, digits[--ndigits]);
+  }
+
+  buffer[(length < ARMCAT_DISASM_INSTR_SIZEMAX) ? length : ARMCAT_DISASM_INSTR_SIZEMAX - 1] = '\0';
+  va_end(args);
+}
 
 /**
  * @brief Disassembles and formats MUL/MLA instructions.
@@ -44,16 +110,22 @@ const char *registers[ARMCAT_REGISTERS_AMOUNTMAX] = {
  */
 
 static armcat_status_t disasm_format_mul_instr(armcat_instr_t *instr) {
-  const armcat_mul_instr_t *decoded = decode_mul_instr(instr->instr);
+  const armcat_mul_instr_t *decoded = decode_mul_instr(&(armcat_mul_instr_t){0}, instr->instr);
+
+  const uint32_t semantics = (ARMCAT_SETFLAGS_BIT_DECODE(instr->instr) ? ARMCAT_SEMANTIC_SETS_FLAGS : 0);
+  const uint16_t rmask = ARMCAT_REGISTER_BIT(decoded->src) | ARMCAT_REGISTER_BIT(decoded->operand);
 
   switch (decoded->type) {
     case ARMCAT_MULINSTR_BIT_TYPE_MUL:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "mul%s\tr%d, r%d, r%d", 
-        condition_codes[decoded->code], decoded->dst, decoded->src, decoded->operand);
+      decode_semantics(instr, semantics, rmask, ARMCAT_REGISTER_BIT(decoded->dst));
+      disasm_printf(instr->disasm_instr, "mul%s\tr%d, r%d, r%d", 
+        ARMCAT_CONDITION_NAME(decoded->code), decoded->dst, decoded->src, decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_MULINSTR_BIT_TYPE_MLA:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "mla%s\tr%d, r%d, r%d", 
-        condition_codes[decoded->code], decoded->dst, decoded->src, decoded->operand);
+      decode_semantics(instr, semantics, rmask | ARMCAT_REGISTER_BIT(ARMCAT_DSTREG_DECODE(instr->instr)), 
+        ARMCAT_REGISTER_BIT(decoded->dst));
+      disasm_printf(instr->disasm_instr, "mla%s\tr%d, r%d, r%d", 
+        ARMCAT_CONDITION_NAME(decoded->code), decoded->dst, decoded->src, decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
   }
 
@@ -69,45 +141,57 @@ static armcat_status_t disasm_format_mul_instr(armcat_instr_t *instr) {
 static armcat_status_t disasm_format_data_instr(armcat_instr_t *instr,
   const armcat_opcode_table_t *info)
 {
-  const armcat_data_instr_t *decoded = decode_data_instr(instr->instr);
+  const armcat_data_instr_t *decoded = decode_data_instr(&(armcat_data_instr_t){0}, instr->instr);
+
+  const uint32_t semantics = info->semantics | (ARMCAT_SETFLAGS_BIT_DECODE(instr->instr) ? ARMCAT_SEMANTIC_SETS_FLAGS : 0);
+
+  /* Register operands read Rm, and Rs as well when Rm is shifted by a register. */
+  const uint16_t operands = ARMCAT_REGISTER_BIT(decoded->operand) | (ARMCAT_DATAINSTR_REGSHIFT_DECODE(instr->instr)
+    ? ARMCAT_REGISTER_BIT(ARMCAT_DATAINSTR_SHIFTREG_DECODE(instr->instr)) : 0);
 
   switch (decoded->type) {
     case ARMCAT_DATAINSTR_BIT_TYPE0:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, %s, %s",
-        info->mnemonic, condition_codes[decoded->code], registers[decoded->dst], registers[decoded->src], registers[decoded->operand]);
+      decode_semantics(instr, semantics, operands, 0);
+      disasm_printf(instr->disasm_instr, "%s%s\t%s, %s, %s",
+        ARMCAT_MNEMONIC(info), ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->src), ARMCAT_REGISTER_NAME(ARMCAT_OPERAND_REGISTER_DECODE(decoded->operand)));
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_DATAINSTR_BIT_TYPE1:
+      decode_semantics(instr, semantics, operands, 0);
+
       if ((info->opcode == ARMCAT_INSTR_CMP1 || info->opcode == ARMCAT_INSTR_CMP2) || (info->opcode == ARMCAT_INSTR_TST1 || info->opcode == ARMCAT_INSTR_TST2) 
         || (info->opcode == ARMCAT_INSTR_CMN1 || info->opcode == ARMCAT_INSTR_CMN2) || (info->opcode == ARMCAT_INSTR_TEQ1 || info->opcode == ARMCAT_INSTR_TEQ2))
       {
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, %s",
-          info->mnemonic, condition_codes[decoded->code], registers[decoded->src], registers[decoded->operand]);
+        disasm_printf(instr->disasm_instr, "%s%s\t%s, %s",
+          ARMCAT_MNEMONIC(info), ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->src), ARMCAT_REGISTER_NAME(ARMCAT_OPERAND_REGISTER_DECODE(decoded->operand)));
         return ARMCAT_STATUS_SUCCESS;
       }
 
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, %s",
-        info->mnemonic, condition_codes[decoded->code], registers[decoded->dst], registers[decoded->operand]);
+      disasm_printf(instr->disasm_instr, "%s%s\t%s, %s",
+        ARMCAT_MNEMONIC(info), ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(ARMCAT_OPERAND_REGISTER_DECODE(decoded->operand)));
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_DATAINSTR_BIT_TYPE2:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, %s, #0x%x", info->mnemonic, 
-        condition_codes[decoded->code], registers[decoded->dst], registers[decoded->src], decoded->operand);
+      decode_semantics(instr, semantics, 0, 0);
+      disasm_printf(instr->disasm_instr, "%s%s\t%s, %s, #0x%x", ARMCAT_MNEMONIC(info), 
+        ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->src), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_DATAINSTR_BIT_TYPE3:
+      decode_semantics(instr, semantics, 0, 0);
+
       if (!decoded->rot) {
         if ((info->opcode == ARMCAT_INSTR_CMP1 || info->opcode == ARMCAT_INSTR_CMP2) || (info->opcode == ARMCAT_INSTR_TST1 || info->opcode == ARMCAT_INSTR_TST2) 
           || (info->opcode == ARMCAT_INSTR_CMN1 || info->opcode == ARMCAT_INSTR_CMN2) || (info->opcode == ARMCAT_INSTR_TEQ1 || info->opcode == ARMCAT_INSTR_TEQ2))
         {
-          snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, #0x%x", info->mnemonic,
-            condition_codes[decoded->code], registers[decoded->src], decoded->operand);
+          disasm_printf(instr->disasm_instr, "%s%s\t%s, #0x%x", ARMCAT_MNEMONIC(info),
+            ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->src), decoded->operand);
           return ARMCAT_STATUS_SUCCESS;
         }
 
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, #0x%x", info->mnemonic,
-          condition_codes[decoded->code], registers[decoded->dst], decoded->operand);
+        disasm_printf(instr->disasm_instr, "%s%s\t%s, #0x%x", ARMCAT_MNEMONIC(info),
+          ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->dst), decoded->operand);
         return ARMCAT_STATUS_SUCCESS;
       }
 
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\tr%d, #0x%x", info->mnemonic,
+      disasm_printf(instr->disasm_instr, "%s\tr%d, #0x%x", ARMCAT_MNEMONIC(info),
         decoded->dst, ARMCAT_OPERAND_ROTATE(decoded->operand, decoded->rot));
       return ARMCAT_STATUS_SUCCESS;
   }
@@ -118,45 +202,58 @@ static armcat_status_t disasm_format_data_instr(armcat_instr_t *instr,
 /**
  * @brief Disassembles and formats branching instructions.
  * @param instr A structure containing the decoded instruction attributes.
+ * @param used Receives the opcode table entry the mnemonic was taken from, NULL if it was not.
  * @returns ARMLIB_DISASM_SUCCESS if the instruction could be disassembled, ARMLIB_DISASM_FAILURE if otherwise.
  */
 
 static armcat_status_t disasm_format_branch_instr(armcat_instr_t *instr,
-  const armcat_opcode_table_t *info)
+  const armcat_opcode_table_t *info, const armcat_opcode_table_t **used)
 {
-  const armcat_branch_instr_t *decoded = decode_branch_instr(instr->instr);
+  const armcat_branch_instr_t *decoded = decode_branch_instr(&(armcat_branch_instr_t){0}, instr->instr);
 
-  switch (decoded->opcode) {
+  /* BLX is not in the opcode table, and BX is only named by its own entry. */
+  *used = (decoded->code == ARMCAT_CONDITION_CODE_UNCONDITIONAL) ? NULL : info;
+
+  /* Immediate branches keep part of their offset in bits 7:4, which must not be mistaken for BX/BLX. */
+  switch (ARMCAT_BRANCH_IMMEDIATE_DECODE(instr->instr) ? 0 : decoded->opcode) {
     case ARMCAT_BRANCH_OPCODE_TYPE_BX_REGIMM:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "bx%s\tr%d", 
-        condition_codes[decoded->code], decoded->operand);
+      *used = (info->mnemonic == ARMCAT_MNEMONIC_BX) ? *used : NULL;
+      decode_semantics(instr, ARMCAT_SEMANTICS_JUMP, ARMCAT_REGISTER_BIT(decoded->operand), 0);
+      disasm_printf(instr->disasm_instr, "bx%s\tr%d", 
+        ARMCAT_CONDITION_NAME(decoded->code), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_BRANCH_OPCODE_TYPE_BLX_REGIMM:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "blx%s\tr%d", 
-        condition_codes[decoded->code], decoded->operand);
+      *used = NULL;
+      decode_semantics(instr, ARMCAT_SEMANTICS_CALL, ARMCAT_REGISTER_BIT(decoded->operand), 0);
+      disasm_printf(instr->disasm_instr, "blx%s\tr%d", 
+        ARMCAT_CONDITION_NAME(decoded->code), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
   }
 
   switch (decoded->type) {
     case ARMCAT_BRANCH_BIT_TYPE_B:
       if (info->opcode == 0xa4 && decoded->code == ARMCAT_CONDITION_CODE_AL)
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "b\t#0x%x",
+        disasm_printf(instr->disasm_instr, "b\t#0x%x",
           ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 8));
       else
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "b%s\t#0x%x",
-          condition_codes[decoded->code], ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 12));
+        disasm_printf(instr->disasm_instr, "b%s\t#0x%x",
+          ARMCAT_CONDITION_NAME(decoded->code), ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 12));
 
       if (decoded->code == ARMCAT_CONDITION_CODE_UNCONDITIONAL)
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "blx%s\t#0x%x", 
-          condition_codes[decoded->code], ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 16));
-      
+        disasm_printf(instr->disasm_instr, "blx%s\t#0x%x", 
+          ARMCAT_CONDITION_NAME(decoded->code), ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 16));
+
+      decode_semantics(instr, (decoded->code == ARMCAT_CONDITION_CODE_UNCONDITIONAL) ? ARMCAT_SEMANTICS_CALL 
+        : info->semantics, 0, 0);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_BRANCH_BIT_TYPE_BL:
+      decode_semantics(instr, info->semantics, 0, 0);
+
       if (decoded->code == ARMCAT_CONDITION_CODE_AL)
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "bl\t#0x%x", 
+        disasm_printf(instr->disasm_instr, "bl\t#0x%x", 
           ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 16));
       else
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "bl%s\t#0x%x", condition_codes[decoded->code],
+        disasm_printf(instr->disasm_instr, "bl%s\t#0x%x", ARMCAT_CONDITION_NAME(decoded->code),
           ((ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2) + 8));
       return ARMCAT_STATUS_SUCCESS;
   }
@@ -173,28 +270,35 @@ static armcat_status_t disasm_format_branch_instr(armcat_instr_t *instr,
 static armcat_status_t disasm_format_ldrstr_instr(armcat_instr_t *instr,
   const armcat_opcode_table_t *info)
 {
-  const armcat_ldrstr_instr_t *decoded = decode_ldrstr_instr(instr->instr);
+  const armcat_ldrstr_instr_t *decoded = decode_ldrstr_instr(&(armcat_ldrstr_instr_t){0}, instr->instr);
+
+  /* Post-indexed and write-back addressing modes update the base register. */
+  const uint16_t wmask = (!ARMCAT_LDRSTR_PREINDEX_DECODE(instr->instr) || ARMCAT_LDRSTR_WRITEBACK_DECODE(instr->instr)) 
+    ? ARMCAT_REGISTER_BIT(decoded->src) : 0;
 
   switch (decoded->immediate) {
     case ARMCAT_INSTR_LDRSTR_IMM:
+      decode_semantics(instr, info->semantics, 0, wmask);
+
       if (!decoded->offset && decoded->updown == ARMCAT_INSTR_UD_SET) {
         if (decoded->branch == ARMCAT_INSTR_BRANCH_SET) {
-          snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%sb\t%s, [%s]", info->mnemonic, 
-            registers[decoded->dst], registers[decoded->src]);
+          disasm_printf(instr->disasm_instr, "%sb\t%s, [%s]", ARMCAT_MNEMONIC(info), 
+            ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->src));
           return ARMCAT_STATUS_SUCCESS;
         }
 
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t%s, [%s]", info->mnemonic, 
-          registers[decoded->dst], registers[decoded->src]);
+        disasm_printf(instr->disasm_instr, "%s\t%s, [%s]", ARMCAT_MNEMONIC(info), 
+          ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->src));
         return ARMCAT_STATUS_SUCCESS;
       }
 
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t%s, [%s, #0x%x]", info->mnemonic,
-        registers[decoded->dst], registers[decoded->src], decoded->operand);
+      disasm_printf(instr->disasm_instr, "%s\t%s, [%s, #0x%x]", ARMCAT_MNEMONIC(info),
+        ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->src), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_INSTR_LDRSTR_REGIMM:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t%s, [%s, %s]", info->mnemonic,
-        registers[decoded->dst], registers[decoded->src], registers[decoded->operand]);
+      decode_semantics(instr, info->semantics, ARMCAT_REGISTER_BIT(decoded->operand), wmask);
+      disasm_printf(instr->disasm_instr, "%s\t%s, [%s, %s]", ARMCAT_MNEMONIC(info),
+        ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->src), ARMCAT_REGISTER_NAME(ARMCAT_OPERAND_REGISTER_DECODE(decoded->operand)));
       return ARMCAT_STATUS_SUCCESS;
   }
 
@@ -204,70 +308,91 @@ static armcat_status_t disasm_format_ldrstr_instr(armcat_instr_t *instr,
 /**
  * @brief Disassembles and formats miscellaneous instructions.
  * @param instr A structure containing the decoded instruction attributes.
+ * @param info The opcode table entry of the instruction, NULL if there is none.
+ * @param used Receives the opcode table entry the mnemonic was taken from, NULL if it was not.
  * @returns ARMLIB_DISASM_SUCCESS if the instruction could be disassembled, ARMLIB_DISASM_FAILURE if otherwise.
  */
 
-static armcat_status_t disasm_misc_instr(armcat_instr_t *instr) {
-  const armcat_opcode_table_t *info = decode_opcode(instr->instr);
+static armcat_status_t disasm_misc_instr(armcat_instr_t *instr, const armcat_opcode_table_t *info,
+  const armcat_opcode_table_t **used)
+{
   if (!info)
     return ARMCAT_STATUS_FAILURE;
 
-  const armcat_misc_instr_t *decoded = decode_misc_instr(instr->instr);
+  /* HVC, BXJ, BKPT and MUL/MLA share opcode bytes with other entries and are named here instead. */
+  *used = NULL;
+
+  const armcat_misc_instr_t *decoded = decode_misc_instr(&(armcat_misc_instr_t){0}, instr->instr);
 
   switch (decoded->optype) {
     case ARMCAT_INSTR_MISC_GROUP1:
       if (decoded->opcode == ARMCAT_INSTR_HVC) {
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "hvc%s\t#0x%x",
-          condition_codes[decoded->code], decoded->moperand);
+        decode_semantics(instr, 0, 0, 0);
+        disasm_printf(instr->disasm_instr, "hvc%s\t#0x%x",
+          ARMCAT_CONDITION_NAME(decoded->code), decoded->moperand);
         return ARMCAT_STATUS_SUCCESS;
       }
       break;
     case ARMCAT_INSTR_MISC_GROUP2:
       if (decoded->opcode == ARMCAT_INSTR_BXJ) {
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "bxj%s\t%s",
-          condition_codes[decoded->code], registers[decoded->moperand]);
+        decode_semantics(instr, ARMCAT_SEMANTICS_JUMP, ARMCAT_REGISTER_BIT(decoded->moperand), 0);
+        disasm_printf(instr->disasm_instr, "bxj%s\t%s",
+          ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->moperand));
         return ARMCAT_STATUS_SUCCESS;
       }
       break;
     case ARMCAT_INSTR_MISC_GROUP3:
       if (decoded->opcode == ARMCAT_INSTR_CLZ) {
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t%s, %s",
-          info->mnemonic, condition_codes[decoded->code], registers[decoded->dst], registers[decoded->moperand]);
+        *used = info;
+        decode_semantics(instr, ARMCAT_SEMANTICS_MOVE, ARMCAT_REGISTER_BIT(decoded->moperand), 0);
+        disasm_printf(instr->disasm_instr, "%s%s\t%s, %s",
+          ARMCAT_MNEMONIC(info), ARMCAT_CONDITION_NAME(decoded->code), ARMCAT_REGISTER_NAME(decoded->dst), ARMCAT_REGISTER_NAME(decoded->moperand));
         return ARMCAT_STATUS_SUCCESS;
       }
       break;
     case ARMCAT_INSTR_MISC_GROUP4:
       if (decoded->opcode == ARMCAT_INSTR_BKPT) {
-        snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "bkpt%s\t#0x%x", 
-          condition_codes[decoded->code], decoded->moperand);
+        decode_semantics(instr, 0, 0, 0);
+        disasm_printf(instr->disasm_instr, "bkpt%s\t#0x%x", 
+          ARMCAT_CONDITION_NAME(decoded->code), decoded->moperand);
         return ARMCAT_STATUS_SUCCESS;
       }
       break;
   }
 
-  switch (info->opcode) {
+  switch ((*used = info)->opcode) {
     case ARMCAT_INSTR_SVC:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s\t#0x%x", info->mnemonic, 
-        condition_codes[decoded->code], decoded->operand);
+      decode_semantics(instr, info->semantics, 0, 0);
+      disasm_printf(instr->disasm_instr, "%s%s\t#0x%x", ARMCAT_MNEMONIC(info), 
+        ARMCAT_CONDITION_NAME(decoded->code), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_INSTR_NOP:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s%s", info->mnemonic, condition_codes[decoded->code]);
+      decode_semantics(instr, info->semantics, 0, 0);
+      disasm_printf(instr->disasm_instr, "%s%s", ARMCAT_MNEMONIC(info), ARMCAT_CONDITION_NAME(decoded->code));
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_INSTR_RFE:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t%s", info->mnemonic, registers[decoded->src]);
+      decode_semantics(instr, info->semantics, 0, ARMCAT_LDRSTR_WRITEBACK_DECODE(instr->instr) 
+        ? ARMCAT_REGISTER_BIT(decoded->src) : 0);
+      disasm_printf(instr->disasm_instr, "%s\t%s", ARMCAT_MNEMONIC(info), ARMCAT_REGISTER_NAME(decoded->src));
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_INSTR_RFEDB:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t%s", info->mnemonic, registers[decoded->src]);
+      decode_semantics(instr, info->semantics, 0, ARMCAT_LDRSTR_WRITEBACK_DECODE(instr->instr) 
+        ? ARMCAT_REGISTER_BIT(decoded->src) : 0);
+      disasm_printf(instr->disasm_instr, "%s\t%s", ARMCAT_MNEMONIC(info), ARMCAT_REGISTER_NAME(decoded->src));
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_INSTR_CPS:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t#0x%x", info->mnemonic, decoded->operand);
+      decode_semantics(instr, info->semantics, 0, 0);
+      disasm_printf(instr->disasm_instr, "%s\t#0x%x", ARMCAT_MNEMONIC(info), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
     case ARMCAT_INSTR_PLI:
-      snprintf(instr->disasm_instr, ARMCAT_DISASM_INSTR_SIZEMAX, "%s\t[%s, #0x%x]", info->mnemonic,
-        registers[decoded->src], decoded->operand);
+      decode_semantics(instr, info->semantics, 0, 0);
+      disasm_printf(instr->disasm_instr, "%s\t[%s, #0x%x]", ARMCAT_MNEMONIC(info),
+        ARMCAT_REGISTER_NAME(decoded->src), decoded->operand);
       return ARMCAT_STATUS_SUCCESS;
   }
 
+  *used = NULL;
+
   switch (decoded->type) {
     case ARMCAT_INSTR_TYPE_MUL:
       return disasm_format_mul_instr(instr);
@@ -277,30 +402,58 @@ static armcat_status_t disasm_misc_instr(armcat_instr_t *instr) {
 }
 
 /**
- * @brief Disassembles an instruction.
+ * @brief Decodes and formats an instruction.
  * @param instr A structure containing the decoded instruction attributes.
- * @param data The encoded instruction.
+ * @param used Receives the opcode table entry the mnemonic was taken from, NULL if it was not.
  * @returns ARMLIB_DISASM_SUCCESS if the instruction could be disassembled, ARMLIB_DISASM_FAILURE if otherwise.
  */
 
-armcat_status_t disasm_instr(armcat_instr_t *instr, const uint32_t data) {
-  instr->instr = data;
+static armcat_status_t disasm_decode_instr(armcat_instr_t *instr, const armcat_opcode_table_t **used) {
+  const armcat_opcode_table_t *info = decode_opcode(instr->instr);
 
-  if (disasm_misc_instr(instr) == ARMCAT_STATUS_SUCCESS)
+  if (disasm_misc_instr(instr, info, used) == ARMCAT_STATUS_SUCCESS)
     return ARMCAT_STATUS_SUCCESS;
 
-  const armcat_opcode_table_t *info = decode_opcode(instr->instr);
-  if (!info)
+  if (!(*used = info))
     return ARMCAT_STATUS_FAILURE;
 
   switch (info->group) {
     case LOAD_STORE:
       return disasm_format_ldrstr_instr(instr, info);
     case BRANCHING:
-      return disasm_format_branch_instr(instr, info);
+      return disasm_format_branch_instr(instr, info, used);
     case DATA_PROCESSING:
       return disasm_format_data_instr(instr, info);
   }
 
   return ARMCAT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Disassembles an instruction, reporting the opcode table entry its mnemonic was taken from.
+ * @param instr A structure containing the decoded instruction attributes.
+ * @param data The encoded instruction.
+ * @param used Receives the opcode table entry, NULL if the mnemonic does not come from the opcode table.
+ * @returns ARMLIB_DISASM_SUCCESS if the instruction could be disassembled, ARMLIB_DISASM_FAILURE if otherwise.
+ */
+
+armcat_status_t disasm_instr_opcode(armcat_instr_t *instr, const uint32_t data, const armcat_opcode_table_t **used) {
+  instr->instr = data;
+  instr->rmask = instr->wmask = instr->flags = 0;
+
+  if ((instr->status = disasm_decode_instr(instr, used)) != ARMCAT_STATUS_SUCCESS)
+    *used = NULL;
+
+  return instr->status;
+}
+
+/**
+ * @brief Disassembles an instruction.
+ * @param instr A structure containing the decoded instruction attributes.
+ * @param data The encoded instruction.
+ * @returns ARMLIB_DISASM_SUCCESS if the instruction could be disassembled, ARMLIB_DISASM_FAILURE if otherwise.
+ */
+
+armcat_status_t disasm_instr(armcat_instr_t *instr, const uint32_t data) {
+  return disasm_instr_opcode(instr, data, &(const armcat_opcode_table_t *){NULL});
 }
\ No newline at end of file
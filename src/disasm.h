@@ -19,9 +19,12 @@
 #ifndef __DISASM_H
 #define __DISASM_H
 
-#include <stdio.h>
 #include <stdint.h>
-#include <stdlib.h>
+
+#ifndef ARMCAT_FREESTANDING
+  #include <stdio.h>
+  #include <stdlib.h>
+#endif
 
 #include "armcat.h"
 #include "decode.h"
@@ -46,11 +49,14 @@ static armcat_status_t disasm_format_data_instr(armcat_instr_t *instr,
   const armcat_opcode_table_t *info);
 
 static armcat_status_t disasm_format_branch_instr(armcat_instr_t *instr,
-  const armcat_opcode_table_t *info);
+  const armcat_opcode_table_t *info, const armcat_opcode_table_t **used);
 
 static armcat_status_t disasm_format_ldrstr_instr(armcat_instr_t *instr,
   const armcat_opcode_table_t *info);
 
+static armcat_status_t disasm_decode_instr(armcat_instr_t *instr, const armcat_opcode_table_t **used);
+
 armcat_status_t disasm_instr(armcat_instr_t *instr, const uint32_t data);
+armcat_status_t disasm_instr_opcode(armcat_instr_t *instr, const uint32_t data, const armcat_opcode_table_t **used);
 
 #endif
\ No newline at end of file
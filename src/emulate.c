@@ -0,0 +1,614 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "emulate.h"
+#include "decode.h"
+#include "disasm.h"
+
+/* Attributes of a predecoded operation! */
+#define ARMCAT_EMU_OPF_IMMEDIATE  0x01 /* The operand (or offset) is an immediate. */
+#define ARMCAT_EMU_OPF_SETFLAGS   0x02 /* The condition flags are updated. */
+#define ARMCAT_EMU_OPF_BYTE       0x04 /* The load/store transfers a byte. */
+#define ARMCAT_EMU_OPF_PREINDEX   0x08 /* The offset is applied before the access. */
+#define ARMCAT_EMU_OPF_UP         0x10 /* The offset is added rather than subtracted. */
+#define ARMCAT_EMU_OPF_WRITEBACK  0x20 /* The base register is updated. */
+#define ARMCAT_EMU_OPF_ACCUMULATE 0x40 /* The multiplication accumulates. (MLA) */
+
+/* Macros for the direct-threaded dispatch, jumping straight to the handler of the next operation! */
+#define ARMCAT_EMU_DISPATCH() goto *op->handler
+#define ARMCAT_EMU_NEXT()     do { ++op; goto *op->handler; } while (0)
+
+/* Macro that skips the operation if its condition code fails! */
+#define ARMCAT_EMU_CONDITION() \
+  do { if (!((emu->conditions[op->code] >> (cpu->cpsr >> 28)) & 1)) ARMCAT_EMU_NEXT(); } while (0)
+
+/* Macro that reads a register, pc reads as the address of the instruction plus 8! */
+#define ARMCAT_EMU_REG(reg) (((reg) == 15) ? op->address + 8 : cpu->regs[(reg)])
+
+
+/*
+    *    src/emulate.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Enumerations representing the predecoded operations, data-processing ones follow the ARM opcode order. */
+typedef enum _armcat_emu_kind {
+  ARMCAT_EMU_OP_AND, ARMCAT_EMU_OP_EOR, ARMCAT_EMU_OP_SUB, ARMCAT_EMU_OP_RSB,
+  ARMCAT_EMU_OP_ADD, ARMCAT_EMU_OP_ADC, ARMCAT_EMU_OP_SBC, ARMCAT_EMU_OP_RSC,
+  ARMCAT_EMU_OP_TST, ARMCAT_EMU_OP_TEQ, ARMCAT_EMU_OP_CMP, ARMCAT_EMU_OP_CMN,
+  ARMCAT_EMU_OP_ORR, ARMCAT_EMU_OP_MOV, ARMCAT_EMU_OP_BIC, ARMCAT_EMU_OP_MVN,
+  ARMCAT_EMU_OP_MUL,
+  ARMCAT_EMU_OP_LDR,
+  ARMCAT_EMU_OP_STR,
+  ARMCAT_EMU_OP_B,
+  ARMCAT_EMU_OP_BL,
+  ARMCAT_EMU_OP_BX,
+  ARMCAT_EMU_OP_SVC,
+  ARMCAT_EMU_OP_UNDEFINED,
+  ARMCAT_EMU_OP_FAULT,
+  ARMCAT_EMU_OP_END,
+  ARMCAT_EMU_OP_AMOUNT
+} armcat_emu_kind_t;
+
+/* Structure containing a predecoded operation. */
+typedef struct _armcat_emu_op {
+  const void *handler; /* The address of the handler. */
+  uint32_t address; /* The address of the instruction. */
+  uint32_t imm; /* The immediate operand, load/store offset or branch target. */
+  uint8_t kind; /* The operation. (armcat_emu_kind_t) */
+  uint8_t code; /* The condition code. */
+  uint8_t flags; /* The attributes. (ARMCAT_EMU_OPF_*) */
+  uint8_t rd; /* The destination register. */
+  uint8_t rn; /* The first operand (or base) register. */
+  uint8_t rm; /* The second operand (or offset) register. */
+  uint8_t rs; /* The multiplier register. */
+  uint8_t shift; /* The shift type applied to rm. */
+  uint8_t amount; /* The shift amount, or the rotation of an immediate operand. */
+} armcat_emu_op_t;
+
+/* Structure containing a block of predecoded operations, always terminated by ARMCAT_EMU_OP_END. */
+struct _armcat_emu_block {
+  uint32_t address; /* The address of the first instruction. */
+  uint32_t nops; /* The amount of instructions, excluding the terminator. */
+  armcat_emu_op_t ops[ARMCAT_EMU_BLOCK_OPMAX + 1]; /* The operations. */
+};
+
+/**
+ * @brief Applies an immediate shift to a register operand.
+ * @param value The register value.
+ * @param type The shift type. (LSL, LSR, ASR, ROR)
+ * @param amount The shift amount, 0 encodes LSR/ASR #32 and RRX.
+ * @param carry The carry flag, receives the shifter carry-out.
+ * @returns The shifted value.
+ */
+
+static inline __always_inline uint32_t emu_shift(const uint32_t value, const uint32_t type, const uint32_t amount,
+  uint32_t *carry)
+{
+  switch (type) {
+    case 0:
+      if (!amount)
+        return value;
+
+      *carry = (value >> (32 - amount)) & 1;
+      return value << amount;
+    case 1:
+      *carry = amount ? (value >> (amount - 1)) & 1 : value >> 31;
+      return amount ? value >> amount : 0;
+    case 2:
+      *carry = amount ? ((int32_t)value >> (amount - 1)) & 1 : value >> 31;
+      return amount ? (uint32_t)((int32_t)value >> amount) : (uint32_t)((int32_t)value >> 31);
+    default: {
+      const uint32_t result = amount ? ((value >> amount) | (value << (32 - amount))) : ((*carry << 31) | (value >> 1));
+
+      *carry = amount ? result >> 31 : value & 1;
+      return result;
+    }
+  }
+}
+
+/**
+ * @brief Translates an emulated address into a host pointer.
+ * @param emu The emulator.
+ * @param address The address.
+ * @param size The size of the access.
+ * @returns The host pointer, NULL if the access falls outside of the emulated memory.
+ */
+
+static inline __always_inline uint8_t *emu_translate(const armcat_emu_t *emu, const uint32_t address, const size_t size) {
+  const uint32_t offset = address - emu->base;
+
+  return (emu->size >= size && offset <= emu->size - size) ? &emu->memory[offset] : NULL;
+}
+
+/**
+ * @brief Predecodes a data-processing instruction.
+ * @param op The operation.
+ * @param instr The encoded instruction.
+ */
+
+static void emu_predecode_data(armcat_emu_op_t *op, const uint32_t instr) {
+  const armcat_data_instr_t *decoded = decode_data_instr(&(armcat_data_instr_t){0}, instr);
+
+  op->kind = ARMCAT_PARSE_BITS(instr, 21, 24);
+  op->rd   = decoded->dst;
+  op->rn   = decoded->src;
+
+  if (ARMCAT_SETFLAGS_BIT_DECODE(instr))
+    op->flags |= ARMCAT_EMU_OPF_SETFLAGS;
+
+  if (decoded->type & 0x2) {
+    op->flags |= ARMCAT_EMU_OPF_IMMEDIATE;
+    op->amount = decoded->rot;
+    op->imm    = ARMCAT_OPERAND_ROTATE(decoded->operand, decoded->rot);
+  }
+  else {
+    op->rm     = decoded->operand & 0xf;
+    op->shift  = ARMCAT_PARSE_BITS(instr, 5, 6);
+    op->amount = ARMCAT_PARSE_BITS(instr, 7, 11);
+  }
+
+  /* Compares without the S bit encode other instructions, and shifts by register are not modelled. */
+  if ((op->kind >= ARMCAT_EMU_OP_TST && op->kind <= ARMCAT_EMU_OP_CMN && !(op->flags & ARMCAT_EMU_OPF_SETFLAGS))
+    || (!(op->flags & ARMCAT_EMU_OPF_IMMEDIATE) && ARMCAT_PARSE_BITS(instr, 4, 4)))
+    op->kind = ARMCAT_EMU_OP_UNDEFINED;
+}
+
+/**
+ * @brief Predecodes a load/store instruction.
+ * @param op The operation.
+ * @param instr The encoded instruction.
+ */
+
+static void emu_predecode_ldrstr(armcat_emu_op_t *op, const uint32_t instr) {
+  const armcat_ldrstr_instr_t *decoded = decode_ldrstr_instr(&(armcat_ldrstr_instr_t){0}, instr);
+
+  op->kind = decoded->type ? ARMCAT_EMU_OP_LDR : ARMCAT_EMU_OP_STR;
+  op->rd   = decoded->dst;
+  op->rn   = decoded->src;
+
+  op->flags |= (decoded->branch ? ARMCAT_EMU_OPF_BYTE : 0) | (decoded->updown ? ARMCAT_EMU_OPF_UP : 0)
+    | (ARMCAT_LDRSTR_PREINDEX_DECODE(instr) ? ARMCAT_EMU_OPF_PREINDEX : 0);
+
+  if (!ARMCAT_LDRSTR_PREINDEX_DECODE(instr) || ARMCAT_LDRSTR_WRITEBACK_DECODE(instr))
+    op->flags |= ARMCAT_EMU_OPF_WRITEBACK;
+
+  if (decoded->immediate == ARMCAT_INSTR_LDRSTR_IMM) {
+    op->flags |= ARMCAT_EMU_OPF_IMMEDIATE;
+    op->imm    = ARMCAT_PARSE_BITS(instr, 0, 11);
+  }
+  else {
+    op->rm     = decoded->operand & 0xf;
+    op->shift  = ARMCAT_PARSE_BITS(instr, 5, 6);
+    op->amount = ARMCAT_PARSE_BITS(instr, 7, 11);
+  }
+
+  /* Register offsets with bit 4 set are media instructions, and pc write-back is unpredictable. */
+  if ((decoded->immediate == ARMCAT_INSTR_LDRSTR_REGIMM && ARMCAT_PARSE_BITS(instr, 4, 4))
+    || ((op->flags & ARMCAT_EMU_OPF_WRITEBACK) && op->rn == 15))
+    op->kind = ARMCAT_EMU_OP_UNDEFINED;
+}
+
+/**
+ * @brief Predecodes a single instruction.
+ * @param op The operation.
+ * @param instr The encoded instruction.
+ * @param address The address of the instruction.
+ * @returns 1 if the operation ends the block, 0 if otherwise.
+ */
+
+static int emu_predecode(armcat_emu_op_t *op, const uint32_t instr, const uint32_t address) {
+  memset(op, 0, sizeof(armcat_emu_op_t));
+
+  op->address = address;
+  op->code    = ARMCAT_CONDITION_CODE_DECODE(instr);
+  op->kind    = ARMCAT_EMU_OP_UNDEFINED;
+
+  if (op->code == ARMCAT_CONDITION_CODE_UNCONDITIONAL)
+    return 1;
+
+  if (ARMCAT_PARSE_BITS(instr, 24, 27) == 0xF) {
+    op->kind = ARMCAT_EMU_OP_SVC;
+    return 1;
+  }
+
+  if (ARMCAT_BRANCH_IMMEDIATE_DECODE(instr)) {
+    op->kind = ARMCAT_PARSE_BITS(instr, 24, 24) ? ARMCAT_EMU_OP_BL : ARMCAT_EMU_OP_B;
+    op->imm  = address + 8 + (ARMCAT_OPERAND_EXTEND(instr, 24) << 2);
+    return 1;
+  }
+
+  if ((instr & 0x0FFFFFF0) == 0x012FFF10) {
+    const armcat_branch_instr_t *decoded = decode_branch_instr(&(armcat_branch_instr_t){0}, instr);
+
+    op->kind = ARMCAT_EMU_OP_BX;
+    op->rm   = decoded->operand;
+    return 1;
+  }
+
+  if ((instr & 0x0FC000F0) == 0x00000090) {
+    const armcat_mul_instr_t *decoded = decode_mul_instr(&(armcat_mul_instr_t){0}, instr);
+
+    op->rd = decoded->dst;
+    op->rm = decoded->src;
+    op->rs = decoded->operand;
+    op->rn = ARMCAT_DSTREG_DECODE(instr);
+
+    op->flags |= (decoded->type == ARMCAT_MULINSTR_BIT_TYPE_MLA ? ARMCAT_EMU_OPF_ACCUMULATE : 0)
+      | (ARMCAT_SETFLAGS_BIT_DECODE(instr) ? ARMCAT_EMU_OPF_SETFLAGS : 0);
+
+    op->kind = (op->rd == 15) ? ARMCAT_EMU_OP_UNDEFINED : ARMCAT_EMU_OP_MUL;
+    return op->kind == ARMCAT_EMU_OP_UNDEFINED;
+  }
+
+  switch (ARMCAT_PARSE_BITS(instr, 26, 27)) {
+    case 0x0:
+      /* Other encodings with bits 7 and 4 set are extra loads/stores and synchronization primitives. */
+      if (!ARMCAT_PARSE_BITS(instr, 25, 25) && ARMCAT_PARSE_BITS(instr, 4, 4) && ARMCAT_PARSE_BITS(instr, 7, 7))
+        return 1;
+
+      emu_predecode_data(op, instr);
+      break;
+    case 0x1:
+      emu_predecode_ldrstr(op, instr);
+
+      if (op->kind == ARMCAT_EMU_OP_STR)
+        return 0;
+      break;
+    default:
+      return 1;
+  }
+
+  /* Compares never write rd, anything else that writes pc ends the block. */
+  return op->kind == ARMCAT_EMU_OP_UNDEFINED || (op->rd == 15 && (op->kind < ARMCAT_EMU_OP_TST 
+    || op->kind > ARMCAT_EMU_OP_CMN));
+}
+
+/**
+ * @brief Looks up the block starting at an address, predecoding it on a miss.
+ * @param emu The emulator.
+ * @param address The address.
+ * @param handlers The handler of each operation kind.
+ * @returns The block, NULL on failure.
+ */
+
+static armcat_emu_block_t *emu_block(armcat_emu_t *emu, const uint32_t address, const void *const *handlers) {
+  armcat_emu_block_t **slot = &emu->blocks[(address >> 2) & (ARMCAT_EMU_BLOCK_SLOTS - 1)], *block = *slot;
+
+  if (block && block->address == address)
+    return block;
+
+  if (!block && !(block = malloc(sizeof(armcat_emu_block_t))))
+    return NULL;
+
+  block->address = address;
+  block->nops    = 0;
+
+  for (int end = 0; !end && block->nops < ARMCAT_EMU_BLOCK_OPMAX; ++block->nops) {
+    armcat_emu_op_t *op = &block->ops[block->nops];
+
+    const uint32_t pc = address + block->nops * ARMCAT_INSTR_SIZEMAX;
+    const uint8_t *host = (pc & 3) ? NULL : emu_translate(emu, pc, ARMCAT_INSTR_SIZEMAX);
+
+    if (!host) {
+      memset(op, 0, sizeof(armcat_emu_op_t));
+
+      op->address = pc;
+      op->kind    = ARMCAT_EMU_OP_FAULT;
+      end = 1;
+    }
+    else
+      end = emu_predecode(op, *(const uint32_t *)host, pc);
+
+    op->handler = handlers[op->kind];
+  }
+
+  armcat_emu_op_t *terminator = &block->ops[block->nops];
+
+  memset(terminator, 0, sizeof(armcat_emu_op_t));
+
+  terminator->address = address + block->nops * ARMCAT_INSTR_SIZEMAX;
+  terminator->kind    = ARMCAT_EMU_OP_END;
+  terminator->handler = handlers[ARMCAT_EMU_OP_END];
+
+  if (emu->code_start >= emu->code_end)
+    emu->code_start = emu->code_end = address;
+
+  emu->code_start = (address < emu->code_start) ? address : emu->code_start;
+  emu->code_end   = (terminator->address > emu->code_end) ? terminator->address : emu->code_end;
+
+  *slot = block;
+  return block;
+}
+
+/**
+ * @brief Discards every predecoded block, needed after the emulated code is modified from outside.
+ * @param emu The emulator.
+ */
+
+void armcat_emu_invalidate(armcat_emu_t *emu) {
+  for (size_t i = 0; i < ARMCAT_EMU_BLOCK_SLOTS; ++i) {
+    free(emu->blocks[i]);
+    emu->blocks[i] = NULL;
+  }
+
+  emu->code_start = emu->code_end = 0;
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the emulator.
+ * @param emu The emulator.
+ */
+
+void armcat_emu_free(armcat_emu_t *emu) {
+  armcat_emu_invalidate(emu);
+  free(emu);
+}
+
+/**
+ * @brief Creates an emulator over a flat memory region, the CPU state starts zeroed.
+ * @param memory The emulated memory, accessed in place.
+ * @param size The size of the emulated memory.
+ * @param base The address the memory is mapped at.
+ * @returns The emulator, NULL on failure.
+ */
+
+armcat_emu_t *armcat_emu_create(void *memory, const size_t size, const uint32_t base) {
+  armcat_emu_t *emu = calloc(1, sizeof(armcat_emu_t));
+  if (!emu)
+    return NULL;
+
+  emu->memory = memory;
+  emu->size   = size;
+  emu->base   = base;
+
+  for (uint32_t code = 0; code < ARMCAT_CONDITION_CODES_AMOUNTMAX; ++code)
+    for (uint32_t nzcv = 0; nzcv < 16; ++nzcv) {
+      const int n = (nzcv >> 3) & 1, z = (nzcv >> 2) & 1, c = (nzcv >> 1) & 1, v = nzcv & 1;
+      const int passes[ARMCAT_CONDITION_CODES_AMOUNTMAX] = {
+        z, !z, c, !c, n, !n, v, !v, c && !z, !c || z, n == v, n != v, !z && n == v, z || n != v, 1, 1
+      };
+
+      emu->conditions[code] |= passes[code] << nzcv;
+    }
+
+  return emu;
+}
+
+/**
+ * @brief Runs the emulator from the current pc, predecoding each block once.
+ * @param emu The emulator.
+ * @param max_steps The step budget, checked before entering each block.
+ * @returns The reason the emulator stopped. (ARMCAT_EMU_EXIT_*)
+ */
+
+int armcat_emu_run(armcat_emu_t *emu, const size_t max_steps) {
+  static const void *const handlers[ARMCAT_EMU_OP_AMOUNT] = {
+    [ARMCAT_EMU_OP_AND] = &&op_and, [ARMCAT_EMU_OP_EOR] = &&op_eor, [ARMCAT_EMU_OP_SUB] = &&op_sub,
+    [ARMCAT_EMU_OP_RSB] = &&op_rsb, [ARMCAT_EMU_OP_ADD] = &&op_add, [ARMCAT_EMU_OP_ADC] = &&op_adc,
+    [ARMCAT_EMU_OP_SBC] = &&op_sbc, [ARMCAT_EMU_OP_RSC] = &&op_rsc, [ARMCAT_EMU_OP_TST] = &&op_tst,
+    [ARMCAT_EMU_OP_TEQ] = &&op_teq, [ARMCAT_EMU_OP_CMP] = &&op_cmp, [ARMCAT_EMU_OP_CMN] = &&op_cmn,
+    [ARMCAT_EMU_OP_ORR] = &&op_orr, [ARMCAT_EMU_OP_MOV] = &&op_mov, [ARMCAT_EMU_OP_BIC] = &&op_bic,
+    [ARMCAT_EMU_OP_MVN] = &&op_mvn, [ARMCAT_EMU_OP_MUL] = &&op_mul, [ARMCAT_EMU_OP_LDR] = &&op_ldr,
+    [ARMCAT_EMU_OP_STR] = &&op_str, [ARMCAT_EMU_OP_B]   = &&op_b,   [ARMCAT_EMU_OP_BL]  = &&op_bl,
+    [ARMCAT_EMU_OP_BX]  = &&op_bx,  [ARMCAT_EMU_OP_SVC] = &&op_svc, [ARMCAT_EMU_OP_UNDEFINED] = &&op_undefined,
+    [ARMCAT_EMU_OP_FAULT] = &&op_fault, [ARMCAT_EMU_OP_END] = &&op_end
+  };
+
+  armcat_cpu_t *cpu = &emu->cpu;
+  const armcat_emu_op_t *op;
+
+  uint32_t operand, carry, result, a, b, c;
+  size_t steps = 0;
+
+dispatch:
+  if (steps >= max_steps)
+    return ARMCAT_EMU_EXIT_STEPS;
+
+  const armcat_emu_block_t *block = emu_block(emu, cpu->regs[15], handlers);
+  if (!block)
+    return ARMCAT_EMU_EXIT_FAULT;
+
+  steps += block->nops;
+  op = block->ops;
+
+  ARMCAT_EMU_DISPATCH();
+
+  /* The second operand of data-processing operations and its shifter carry-out. */
+  #define ARMCAT_EMU_OPERAND2() \
+    do { \
+      carry = (cpu->cpsr & ARMCAT_EMU_FLAG_C) ? 1 : 0; \
+      if (op->flags & ARMCAT_EMU_OPF_IMMEDIATE) { \
+        operand = op->imm; \
+        carry = op->amount ? operand >> 31 : carry; \
+      } \
+      else \
+        operand = emu_shift(ARMCAT_EMU_REG(op->rm), op->shift, op->amount, &carry); \
+    } while (0)
+
+op_and: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ARMCAT_EMU_REG(op->rn) & operand; goto logical;
+op_eor: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ARMCAT_EMU_REG(op->rn) ^ operand; goto logical;
+op_orr: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ARMCAT_EMU_REG(op->rn) | operand; goto logical;
+op_bic: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ARMCAT_EMU_REG(op->rn) & ~operand; goto logical;
+op_mov: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = operand; goto logical;
+op_mvn: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ~operand; goto logical;
+op_tst: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ARMCAT_EMU_REG(op->rn) & operand; goto logical;
+op_teq: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); result = ARMCAT_EMU_REG(op->rn) ^ operand; goto logical;
+
+op_sub: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = ARMCAT_EMU_REG(op->rn); b = ~operand; c = 1; goto arithmetic;
+op_rsb: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = operand; b = ~ARMCAT_EMU_REG(op->rn); c = 1; goto arithmetic;
+op_add: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = ARMCAT_EMU_REG(op->rn); b = operand; c = 0; goto arithmetic;
+op_adc: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = ARMCAT_EMU_REG(op->rn); b = operand; c = (cpu->cpsr >> 29) & 1; goto arithmetic;
+op_sbc: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = ARMCAT_EMU_REG(op->rn); b = ~operand; c = (cpu->cpsr >> 29) & 1; goto arithmetic;
+op_rsc: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = operand; b = ~ARMCAT_EMU_REG(op->rn); c = (cpu->cpsr >> 29) & 1; goto arithmetic;
+op_cmp: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = ARMCAT_EMU_REG(op->rn); b = ~operand; c = 1; goto arithmetic;
+op_cmn: ARMCAT_EMU_CONDITION(); ARMCAT_EMU_OPERAND2(); a = ARMCAT_EMU_REG(op->rn); b = operand; c = 0; goto arithmetic;
+
+logical:
+  if (op->flags & ARMCAT_EMU_OPF_SETFLAGS)
+    cpu->cpsr = (cpu->cpsr & ~(ARMCAT_EMU_FLAG_N | ARMCAT_EMU_FLAG_Z | ARMCAT_EMU_FLAG_C)) | (result & ARMCAT_EMU_FLAG_N)
+      | (result ? 0 : ARMCAT_EMU_FLAG_Z) | (carry ? ARMCAT_EMU_FLAG_C : 0);
+  goto writeback;
+
+arithmetic: {
+    const uint64_t sum = (uint64_t)a + b + c;
+
+    result = (uint32_t)sum;
+
+    if (op->flags & ARMCAT_EMU_OPF_SETFLAGS)
+      cpu->cpsr = (cpu->cpsr & 0x0FFFFFFF) | (result & ARMCAT_EMU_FLAG_N) | (result ? 0 : ARMCAT_EMU_FLAG_Z)
+        | ((sum >> 32) ? ARMCAT_EMU_FLAG_C : 0) | (((~(a ^ b) & (a ^ result)) >> 31) ? ARMCAT_EMU_FLAG_V : 0);
+  }
+
+writeback:
+  /* Compares only update the flags. */
+  if (op->kind >= ARMCAT_EMU_OP_TST && op->kind <= ARMCAT_EMU_OP_CMN)
+    ARMCAT_EMU_NEXT();
+
+  if (op->rd == 15) {
+    cpu->regs[15] = result & ~3u;
+    goto dispatch;
+  }
+
+  cpu->regs[op->rd] = result;
+  ARMCAT_EMU_NEXT();
+
+op_mul:
+  ARMCAT_EMU_CONDITION();
+
+  result = cpu->regs[op->rm] * cpu->regs[op->rs] + ((op->flags & ARMCAT_EMU_OPF_ACCUMULATE) ? cpu->regs[op->rn] : 0);
+
+  if (op->flags & ARMCAT_EMU_OPF_SETFLAGS)
+    cpu->cpsr = (cpu->cpsr & ~(ARMCAT_EMU_FLAG_N | ARMCAT_EMU_FLAG_Z)) | (result & ARMCAT_EMU_FLAG_N) 
+      | (result ? 0 : ARMCAT_EMU_FLAG_Z);
+
+  cpu->regs[op->rd] = result;
+  ARMCAT_EMU_NEXT();
+
+  /* The effective address of a load/store, in a (the accessed address) and b (the written-back address). */
+  #define ARMCAT_EMU_ADDRESS() \
+    do { \
+      carry = (cpu->cpsr >> 29) & 1; \
+      operand = (op->flags & ARMCAT_EMU_OPF_IMMEDIATE) ? op->imm \
+        : emu_shift(ARMCAT_EMU_REG(op->rm), op->shift, op->amount, &carry); \
+      a = ARMCAT_EMU_REG(op->rn); \
+      b = (op->flags & ARMCAT_EMU_OPF_UP) ? a + operand : a - operand; \
+      a = (op->flags & ARMCAT_EMU_OPF_PREINDEX) ? b : a; \
+    } while (0)
+
+op_ldr: {
+    ARMCAT_EMU_CONDITION();
+    ARMCAT_EMU_ADDRESS();
+
+    const size_t size = (op->flags & ARMCAT_EMU_OPF_BYTE) ? 1 : ARMCAT_INSTR_SIZEMAX;
+    const uint8_t *host = emu_translate(emu, a, size);
+
+    if (!host)
+      goto fault;
+
+    result = 0;
+    memcpy(&result, host, size);
+
+    if (op->flags & ARMCAT_EMU_OPF_WRITEBACK)
+      cpu->regs[op->rn] = b;
+
+    if (op->rd == 15) {
+      cpu->regs[15] = result & ~3u;
+      goto dispatch;
+    }
+
+    cpu->regs[op->rd] = result;
+    ARMCAT_EMU_NEXT();
+  }
+
+op_str: {
+    ARMCAT_EMU_CONDITION();
+    ARMCAT_EMU_ADDRESS();
+
+    const size_t size = (op->flags & ARMCAT_EMU_OPF_BYTE) ? 1 : ARMCAT_INSTR_SIZEMAX;
+    uint8_t *host = emu_translate(emu, a, size);
+
+    if (!host)
+      goto fault;
+
+    result = ARMCAT_EMU_REG(op->rd);
+    memcpy(host, &result, size);
+
+    if (op->flags & ARMCAT_EMU_OPF_WRITEBACK)
+      cpu->regs[op->rn] = b;
+
+    /* Self-modifying code, the running block may be stale so leave it before discarding everything. */
+    if (a + size > emu->code_start && a < emu->code_end) {
+      cpu->regs[15] = op->address + ARMCAT_INSTR_SIZEMAX;
+
+      armcat_emu_invalidate(emu);
+      goto dispatch;
+    }
+
+    ARMCAT_EMU_NEXT();
+  }
+
+op_b:
+  ARMCAT_EMU_CONDITION();
+
+  cpu->regs[15] = op->imm;
+  goto dispatch;
+
+op_bl:
+  ARMCAT_EMU_CONDITION();
+
+  cpu->regs[14] = op->address + ARMCAT_INSTR_SIZEMAX;
+  cpu->regs[15] = op->imm;
+  goto dispatch;
+
+op_bx:
+  ARMCAT_EMU_CONDITION();
+
+  /* Thumb is not emulated. */
+  if (ARMCAT_EMU_REG(op->rm) & 1) {
+    cpu->regs[15] = op->address;
+    return ARMCAT_EMU_EXIT_UNDEFINED;
+  }
+
+  cpu->regs[15] = ARMCAT_EMU_REG(op->rm) & ~3u;
+  goto dispatch;
+
+op_svc:
+  ARMCAT_EMU_CONDITION();
+
+  cpu->regs[15] = op->address + ARMCAT_INSTR_SIZEMAX;
+  return ARMCAT_EMU_EXIT_SVC;
+
+op_undefined:
+  cpu->regs[15] = op->address;
+  return ARMCAT_EMU_EXIT_UNDEFINED;
+
+fault:
+op_fault:
+  cpu->regs[15] = op->address;
+  return ARMCAT_EMU_EXIT_FAULT;
+
+op_end:
+  cpu->regs[15] = op->address;
+  goto dispatch;
+
+  #undef ARMCAT_EMU_OPERAND2
+  #undef ARMCAT_EMU_ADDRESS
+}
\ No newline at end of file
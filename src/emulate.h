@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __EMULATE_H
+#define __EMULATE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_EMU_BLOCK_OPMAX  64   /* Maximum amount of instructions predecoded into a block. */
+#define ARMCAT_EMU_BLOCK_SLOTS  4096 /* Amount of slots in the direct-mapped block cache. */
+
+/* Reasons for the emulator to stop! */
+#define ARMCAT_EMU_EXIT_STEPS     0 /* The step budget ran out. */
+#define ARMCAT_EMU_EXIT_SVC       1 /* An SVC was executed, pc points past it. */
+#define ARMCAT_EMU_EXIT_UNDEFINED 2 /* An unsupported or undefined instruction was reached, pc points at it. */
+#define ARMCAT_EMU_EXIT_FAULT     3 /* An access fell outside of the emulated memory, pc points at the instruction. */
+
+/* Condition flags in the CPSR! */
+#define ARMCAT_EMU_FLAG_N 0x80000000
+#define ARMCAT_EMU_FLAG_Z 0x40000000
+#define ARMCAT_EMU_FLAG_C 0x20000000
+#define ARMCAT_EMU_FLAG_V 0x10000000
+
+
+/*
+    *    src/emulate.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+typedef struct _armcat_emu_block armcat_emu_block_t;
+
+/* Structure containing the architectural state of the emulated CPU. */
+typedef struct _armcat_cpu {
+  uint32_t regs[16]; /* The general-purpose registers, regs[15] is pc. */
+  uint32_t cpsr; /* The status register, only the condition flags are modelled. */
+} armcat_cpu_t;
+
+/* Structure containing an emulator instance. */
+typedef struct _armcat_emu {
+  armcat_cpu_t cpu; /* The CPU state. */
+  uint8_t *memory; /* The emulated memory. */
+  uint32_t base; /* The address the memory is mapped at. */
+  size_t size; /* The size of the emulated memory. */
+  uint32_t code_start; /* Lowest address covered by a predecoded block. */
+  uint32_t code_end; /* Highest address covered by a predecoded block, exclusive. */
+  uint16_t conditions[16]; /* For each condition code, a bitmask of the NZCV values that pass it. */
+  armcat_emu_block_t *blocks[ARMCAT_EMU_BLOCK_SLOTS]; /* The predecoded blocks, keyed by address. */
+} armcat_emu_t;
+
+void armcat_emu_free(armcat_emu_t *emu);
+void armcat_emu_invalidate(armcat_emu_t *emu);
+
+armcat_emu_t *armcat_emu_create(void *memory, const size_t size, const uint32_t base);
+int armcat_emu_run(armcat_emu_t *emu, const size_t max_steps);
+
+#endif
\ No newline at end of file
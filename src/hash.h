@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __HASH_H
+#define __HASH_H
+
+#include <stdint.h>
+#include <string.h>
+
+/* Multipliers of the buffer hash! */
+#define ARMCAT_HASH_PRIME1 0x9E3779B97F4A7C15ull
+#define ARMCAT_HASH_PRIME2 0xC2B2AE3D27D4EB4Full
+
+
+/*
+    *    src/hash.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Mixes the bits of a 64-bit value.
+ * @param value The value.
+ * @returns The mixed value.
+ */
+
+static inline __always_inline uint64_t hash_mix(uint64_t value) {
+  value ^= value >> 33;
+  value *= ARMCAT_HASH_PRIME2;
+  value ^= value >> 29;
+
+  return value;
+}
+
+/**
+ * @brief Hashes a buffer, fast enough to hash every page of an image.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @param seed The seed, used to key the hash on anything besides the contents.
+ * @returns The 64-bit hash.
+ */
+
+static inline __always_inline uint64_t hash_buffer(const void *buffer, const size_t nbytes, const uint64_t seed) {
+  const uint8_t *bytes = buffer;
+
+  /* Four independent lanes keep the multiplies pipelined. */
+  uint64_t lanes[4] = { seed, seed ^ ARMCAT_HASH_PRIME1, seed ^ ARMCAT_HASH_PRIME2, ~seed }, word = 0;
+  size_t i = 0;
+
+  for (; i + 32 <= nbytes; i += 32)
+    for (size_t k = 0; k < 4; ++k) {
+      memcpy(&word, &bytes[i + k * 8], sizeof(word));
+      lanes[k] = (lanes[k] ^ word) * ARMCAT_HASH_PRIME1;
+      lanes[k] ^= lanes[k] >> 31;
+    }
+
+  uint64_t hash = nbytes ^ lanes[0] ^ (lanes[1] << 1 | lanes[1] >> 63) ^ (lanes[2] << 7 | lanes[2] >> 57) 
+    ^ (lanes[3] << 17 | lanes[3] >> 47);
+
+  for (; i < nbytes; ++i)
+    hash = (hash ^ bytes[i]) * ARMCAT_HASH_PRIME1;
+
+  return hash_mix(hash);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+#include "hexfile.h"
+#include "disasm.h"
+
+#define ARMCAT_HEXFILE_RECORD_MAX 262 /* Maximum size of a decoded record, in bytes. */
+
+
+/*
+    *    src/hexfile.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Decodes a single hex digit.
+ * @param digit The digit.
+ * @returns The value of the digit, -1 if it is not a hex digit.
+ */
+
+static inline __always_inline int hexfile_nibble(const char digit) {
+  if (digit >= '0' && digit <= '9')
+    return digit - '0';
+
+  return ((digit | 0x20) >= 'a' && (digit | 0x20) <= 'f') ? (digit | 0x20) - 'a' + 10 : -1;
+}
+
+/**
+ * @brief Decodes pairs of hex digits into bytes, 16 digits at a time with SSE2.
+ * @param bytes The decoded bytes.
+ * @param digits The digits, two per byte.
+ * @param nbytes The amount of bytes.
+ * @returns 1 if every digit is valid, 0 if otherwise.
+ */
+
+static inline __always_inline int hexfile_decode(uint8_t *bytes, const char *digits, const size_t nbytes) {
+  size_t i = 0;
+
+  #ifdef __SSE2__
+    for (; i + 8 <= nbytes; i += 8) {
+      const __m128i chars = _mm_loadu_si128((const __m128i *)&digits[i * 2]);
+      const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+      const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+      const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+      if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF)
+        return 0;
+
+      const __m128i nibbles = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+        _mm_and_si128(alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+      /* Each 16-bit lane holds the high nibble in its low byte, fold them into one byte per lane and pack. */
+      const __m128i pairs = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x00F0)),
+        _mm_srli_epi16(nibbles, 8));
+
+      _mm_storel_epi64((__m128i *)&bytes[i], _mm_packus_epi16(pairs, pairs));
+    }
+  #endif
+
+  for (; i < nbytes; ++i) {
+    const int high = hexfile_nibble(digits[i * 2]), low = hexfile_nibble(digits[i * 2 + 1]);
+    if (high < 0 || low < 0)
+      return 0;
+
+    bytes[i] = (high << 4) | low;
+  }
+
+  return 1;
+}
+
+/**
+ * @brief Disassembles the complete words of the buffered run and passes them to the callback.
+ * @param hexfile The parser.
+ * @param keep Whether trailing bytes that do not form a word are kept for the next record.
+ * @returns ARMCAT_STATUS_SUCCESS on success, the status of the callback if it fails.
+ */
+
+static armcat_status_t hexfile_flush(armcat_hexfile_t *hexfile, const int keep) {
+  /* Instructions are word-aligned, leading bytes of a misaligned run are skipped. */
+  const size_t skip   = ((-hexfile->run_address) & 3) < hexfile->run_size ? (-hexfile->run_address) & 3 : hexfile->run_size;
+  const size_t ninstr = (hexfile->run_size - skip) / ARMCAT_INSTR_SIZEMAX;
+
+  /* The array is reused, clear the text that a failed decode would otherwise leave behind. */
+  memset(hexfile->instructions, 0, ninstr * sizeof(armcat_instr_t));
+
+  /* The run is byte storage and skip can be 1-3, so words are copied out rather than loaded in place. */
+  for (size_t i = 0; i < ninstr; ++i) {
+    uint32_t word;
+    memcpy(&word, hexfile->run + skip + i * ARMCAT_INSTR_SIZEMAX, sizeof(word));
+
+    disasm_instr(&hexfile->instructions[i], word);
+  }
+
+  const armcat_status_t status = ninstr ? hexfile->callback(hexfile->context, hexfile->run_address + skip,
+    hexfile->instructions, ninstr) : ARMCAT_STATUS_SUCCESS;
+
+  const size_t consumed = skip + ninstr * ARMCAT_INSTR_SIZEMAX;
+
+  if (!keep) {
+    hexfile->run_size = 0;
+    return status;
+  }
+
+  memmove(hexfile->run, hexfile->run + consumed, hexfile->run_size - consumed);
+
+  hexfile->run_address += consumed;
+  hexfile->run_size    -= consumed;
+
+  return status;
+}
+
+/**
+ * @brief Appends data at a load address, flushing the buffered run when the data is not contiguous with it.
+ * @param hexfile The parser.
+ * @param address The load address.
+ * @param data The data.
+ * @param nbytes The size of the data.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+static armcat_status_t hexfile_emit(armcat_hexfile_t *hexfile, const uint32_t address, const uint8_t *data,
+  size_t nbytes)
+{
+  if (hexfile->run_size && address != hexfile->run_address + hexfile->run_size)
+    if (hexfile_flush(hexfile, 0) != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+
+  if (!hexfile->run_size)
+    hexfile->run_address = address;
+
+  while (nbytes) {
+    const size_t size = (nbytes < ARMCAT_HEXFILE_RUN_MAX - hexfile->run_size) ? nbytes 
+      : ARMCAT_HEXFILE_RUN_MAX - hexfile->run_size;
+
+    memcpy(hexfile->run + hexfile->run_size, data, size);
+
+    hexfile->run_size += size;
+    data   += size;
+    nbytes -= size;
+
+    if (hexfile->run_size == ARMCAT_HEXFILE_RUN_MAX && hexfile_flush(hexfile, 1) != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+  }
+
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Parses an Intel HEX record.
+ * @param hexfile The parser.
+ * @param line The record, starting with ':'.
+ * @param length The length of the record.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+static armcat_status_t hexfile_ihex(armcat_hexfile_t *hexfile, const char *line, const size_t length) {
+  uint8_t record[ARMCAT_HEXFILE_RECORD_MAX] = {0};
+  const size_t nbytes = (length - 1) / 2;
+
+  if (!(length & 1) || nbytes < 5 || nbytes > sizeof(record) || !hexfile_decode(record, line + 1, nbytes)
+    || record[0] + 5u != nbytes)
+    return ARMCAT_STATUS_FAILURE;
+
+  uint8_t checksum = 0;
+  for (size_t i = 0; i < nbytes; ++i)
+    checksum += record[i];
+
+  if (checksum)
+    return ARMCAT_STATUS_FAILURE;
+
+  const uint32_t offset = (record[1] << 8) | record[2];
+
+  switch (record[3]) {
+    case 0x00:
+      return hexfile_emit(hexfile, hexfile->upper + offset, &record[4], record[0]);
+    case 0x01:
+      hexfile->done = 1;
+      return ARMCAT_STATUS_SUCCESS;
+    case 0x02:
+      if (record[0] != 2)
+        return ARMCAT_STATUS_FAILURE;
+
+      hexfile->upper = ((record[4] << 8) | record[5]) << 4;
+      return ARMCAT_STATUS_SUCCESS;
+    case 0x04:
+      if (record[0] != 2)
+        return ARMCAT_STATUS_FAILURE;
+
+      hexfile->upper = (uint32_t)((record[4] << 8) | record[5]) << 16;
+      return ARMCAT_STATUS_SUCCESS;
+    case 0x03:
+    case 0x05:
+      /* Start addresses do not affect the image. */
+      return ARMCAT_STATUS_SUCCESS;
+    default:
+      return ARMCAT_STATUS_FAILURE;
+  }
+}
+
+/**
+ * @brief Parses a Motorola S-record.
+ * @param hexfile The parser.
+ * @param line The record, starting with 'S'.
+ * @param length The length of the record.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+static armcat_status_t hexfile_srec(armcat_hexfile_t *hexfile, const char *line, const size_t length) {
+  /* Size of the address field of each record type, 0 for the reserved S4. */
+  static const uint8_t address_sizes[10] = {2, 2, 3, 4, 0, 2, 3, 4, 3, 2};
+
+  uint8_t record[ARMCAT_HEXFILE_RECORD_MAX] = {0};
+  const size_t nbytes = (length - 2) / 2;
+
+  if (length < 2 || line[1] < '0' || line[1] > '9' || !address_sizes[line[1] - '0'])
+    return ARMCAT_STATUS_FAILURE;
+
+  const int type = line[1] - '0';
+  const size_t address_size = address_sizes[type];
+
+  if ((length & 1) || nbytes < address_size + 2 || nbytes > sizeof(record)
+    || !hexfile_decode(record, line + 2, nbytes) || record[0] + 1u != nbytes)
+    return ARMCAT_STATUS_FAILURE;
+
+  uint8_t checksum = 0;
+  for (size_t i = 0; i < nbytes; ++i)
+    checksum += record[i];
+
+  if (checksum != 0xFF)
+    return ARMCAT_STATUS_FAILURE;
+
+  uint32_t address = 0;
+  for (size_t i = 0; i < address_size; ++i)
+    address = (address << 8) | record[1 + i];
+
+  if (type >= 1 && type <= 3)
+    return hexfile_emit(hexfile, address, &record[1 + address_size], nbytes - address_size - 2);
+
+  if (type >= 7)
+    hexfile->done = 1;
+
+  /* Headers and record counts carry no data. */
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Parses a line of hex text, an optional "address:" prefix followed by hex digits.
+ * @param hexfile The parser.
+ * @param line The line.
+ * @param length The length of the line.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+static armcat_status_t hexfile_text(armcat_hexfile_t *hexfile, const char *line, size_t length) {
+  char digits[ARMCAT_HEXFILE_LINE_MAX];
+  uint8_t bytes[ARMCAT_HEXFILE_LINE_MAX / 2];
+
+  const char *colon = memchr(line, ':', length);
+
+  if (colon) {
+    uint32_t address = 0;
+
+    for (const char *digit = line; digit < colon; ++digit) {
+      const int nibble = hexfile_nibble(*digit);
+      if (nibble < 0 || digit - line >= 8)
+        return ARMCAT_STATUS_FAILURE;
+
+      address = (address << 4) | nibble;
+    }
+
+    hexfile->text_address = address;
+    length -= colon + 1 - line;
+    line    = colon + 1;
+  }
+
+  /* Digits may be grouped with whitespace, compact them so they decode as one run. */
+  size_t ndigits = 0;
+  for (size_t i = 0; i < length; ++i)
+    if (line[i] != ' ' && line[i] != '\t')
+      digits[ndigits++] = line[i];
+
+  if (ndigits & 1 || !hexfile_decode(bytes, digits, ndigits / 2))
+    return ARMCAT_STATUS_FAILURE;
+
+  const uint32_t address = hexfile->text_address;
+  hexfile->text_address += ndigits / 2;
+
+  return hexfile_emit(hexfile, address, bytes, ndigits / 2);
+}
+
+/**
+ * @brief Parses a complete line, detecting the format on the first record.
+ * @param hexfile The parser.
+ * @param line The line, without its newline.
+ * @param length The length of the line.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+static armcat_status_t hexfile_line(armcat_hexfile_t *hexfile, const char *line, size_t length) {
+  hexfile->line++;
+
+  while (length && (line[length - 1] == '\r' || line[length - 1] == ' ' || line[length - 1] == '\t'))
+    --length;
+
+  while (length && (*line == ' ' || *line == '\t')) {
+    ++line;
+    --length;
+  }
+
+  if (!length || hexfile->done)
+    return ARMCAT_STATUS_SUCCESS;
+
+  if (hexfile->format == ARMCAT_HEXFILE_AUTO)
+    hexfile->format = (*line == ':') ? ARMCAT_HEXFILE_IHEX 
+      : (*line == 'S' && length > 1 && line[1] >= '0' && line[1] <= '9') ? ARMCAT_HEXFILE_SREC : ARMCAT_HEXFILE_TEXT;
+
+  switch (hexfile->format) {
+    case ARMCAT_HEXFILE_IHEX:
+      return (*line == ':') ? hexfile_ihex(hexfile, line, length) : ARMCAT_STATUS_FAILURE;
+    case ARMCAT_HEXFILE_SREC:
+      return (*line == 'S') ? hexfile_srec(hexfile, line, length) : ARMCAT_STATUS_FAILURE;
+    default:
+      return hexfile_text(hexfile, line, length);
+  }
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the parser.
+ * @param hexfile The parser.
+ */
+
+void armcat_hexfile_free(armcat_hexfile_t *hexfile) {
+  free(hexfile);
+}
+
+/**
+ * @brief Creates a streaming parser.
+ * @param format The input format. (ARMCAT_HEXFILE_*)
+ * @param callback The callback receiving each contiguous run of instructions.
+ * @param context The context passed to the callback.
+ * @returns The parser, NULL on failure.
+ */
+
+armcat_hexfile_t *armcat_hexfile_create(const int format, armcat_hexfile_callback_t callback, void *context) {
+  if (format < ARMCAT_HEXFILE_AUTO || format > ARMCAT_HEXFILE_TEXT || !callback)
+    return NULL;
+
+  armcat_hexfile_t *hexfile = calloc(1, sizeof(armcat_hexfile_t));
+  if (!hexfile)
+    return NULL;
+
+  hexfile->format   = format;
+  hexfile->callback = callback;
+  hexfile->context  = context;
+
+  return hexfile;
+}
+
+/**
+ * @brief Feeds a chunk of input to the parser, chunks may split lines anywhere.
+ * @param hexfile The parser.
+ * @param data The chunk.
+ * @param nbytes The size of the chunk.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure. (hexfile->line is the failing line)
+ */
+
+armcat_status_t armcat_hexfile_feed(armcat_hexfile_t *hexfile, const char *data, size_t nbytes) {
+  while (nbytes) {
+    const char *newline = memchr(data, '\n', nbytes);
+    const size_t length = newline ? (size_t)(newline - data) : nbytes;
+
+    if (hexfile->pending + length > ARMCAT_HEXFILE_LINE_MAX)
+      return ARMCAT_STATUS_FAILURE;
+
+    if (!newline) {
+      memcpy(hexfile->partial + hexfile->pending, data, length);
+      hexfile->pending += length;
+
+      return ARMCAT_STATUS_SUCCESS;
+    }
+
+    /* Complete lines are parsed in place, only a line split across chunks is copied. */
+    armcat_status_t status;
+
+    if (hexfile->pending) {
+      memcpy(hexfile->partial + hexfile->pending, data, length);
+
+      status = hexfile_line(hexfile, hexfile->partial, hexfile->pending + length);
+      hexfile->pending = 0;
+    }
+    else
+      status = hexfile_line(hexfile, data, length);
+
+    if (status != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+
+    data   += length + 1;
+    nbytes -= length + 1;
+  }
+
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Parses the last line if it has no newline and disassembles the remaining buffered run.
+ * @param hexfile The parser.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+armcat_status_t armcat_hexfile_finish(armcat_hexfile_t *hexfile) {
+  if (hexfile->pending) {
+    const size_t pending = hexfile->pending;
+    hexfile->pending = 0;
+
+    if (hexfile_line(hexfile, hexfile->partial, pending) != ARMCAT_STATUS_SUCCESS)
+      return ARMCAT_STATUS_FAILURE;
+  }
+
+  return (hexfile->run_size) ? hexfile_flush(hexfile, 0) : ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Streams a file through a parser in fixed-size chunks.
+ * @param path The path of the file.
+ * @param format The input format. (ARMCAT_HEXFILE_*)
+ * @param callback The callback receiving each contiguous run of instructions.
+ * @param context The context passed to the callback.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+armcat_status_t armcat_hexfile_load(const char *path, const int format, armcat_hexfile_callback_t callback,
+  void *context)
+{
+  armcat_status_t status = ARMCAT_STATUS_FAILURE;
+
+  armcat_hexfile_t *hexfile = armcat_hexfile_create(format, callback, context);
+  char *chunk = malloc(ARMCAT_HEXFILE_CHUNK);
+
+  const int fd = open(path, O_RDONLY);
+
+  if (hexfile && chunk && fd != -1) {
+    ssize_t nbytes;
+
+    while ((nbytes = read(fd, chunk, ARMCAT_HEXFILE_CHUNK)) > 0)
+      if (armcat_hexfile_feed(hexfile, chunk, nbytes) != ARMCAT_STATUS_SUCCESS)
+        break;
+
+    if (!nbytes)
+      status = armcat_hexfile_finish(hexfile);
+  }
+
+  if (fd != -1)
+    close(fd);
+
+  free(chunk);
+
+  if (hexfile)
+    armcat_hexfile_free(hexfile);
+
+  return status;
+}
\ No newline at end of file
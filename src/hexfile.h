@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __HEXFILE_H
+#define __HEXFILE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_HEXFILE_LINE_MAX 1024 /* Maximum length of a record line. */
+#define ARMCAT_HEXFILE_CHUNK    65536 /* Size of the chunks read from a file. */
+#define ARMCAT_HEXFILE_RUN_MAX  ARMCAT_PAGE_SIZE /* Contiguous bytes buffered before they are disassembled. */
+
+/* Input formats! */
+#define ARMCAT_HEXFILE_AUTO 0 /* Detected from the first record. */
+#define ARMCAT_HEXFILE_IHEX 1 /* Intel HEX. */
+#define ARMCAT_HEXFILE_SREC 2 /* Motorola S-records. */
+#define ARMCAT_HEXFILE_TEXT 3 /* Plain hex digits, with optional "address:" line prefixes. */
+
+
+/*
+    *    src/hexfile.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Type-definition for the callback receiving each contiguous run of instructions at its load address. */
+typedef armcat_status_t (*armcat_hexfile_callback_t)(void *context, const uint32_t address,
+  const armcat_instr_t *instructions, const size_t ninstr);
+
+/* Structure containing the state of a streaming parser. */
+typedef struct _armcat_hexfile {
+  int format; /* The input format. */
+  int done; /* Whether a termination record was seen, later lines are ignored. */
+  size_t line; /* The line being parsed, for error reporting. */
+  uint32_t upper; /* Upper address bits set by Intel HEX extended address records. */
+  uint32_t text_address; /* The load address of the next hex-text byte. */
+  armcat_hexfile_callback_t callback; /* The callback. */
+  void *context; /* The context passed to the callback. */
+  size_t pending; /* The length of the partial line carried over from the previous chunk. */
+  char partial[ARMCAT_HEXFILE_LINE_MAX]; /* The partial line. */
+  uint32_t run_address; /* The load address of the buffered run. */
+  size_t run_size; /* The size of the buffered run. */
+  uint8_t run[ARMCAT_HEXFILE_RUN_MAX]; /* The buffered run. */
+  armcat_instr_t instructions[ARMCAT_HEXFILE_RUN_MAX / ARMCAT_INSTR_SIZEMAX]; /* The disassembly of the run. */
+} armcat_hexfile_t;
+
+void armcat_hexfile_free(armcat_hexfile_t *hexfile);
+armcat_hexfile_t *armcat_hexfile_create(const int format, armcat_hexfile_callback_t callback, void *context);
+
+armcat_status_t armcat_hexfile_feed(armcat_hexfile_t *hexfile, const char *data, size_t nbytes);
+armcat_status_t armcat_hexfile_finish(armcat_hexfile_t *hexfile);
+
+armcat_status_t armcat_hexfile_load(const char *path, const int format, armcat_hexfile_callback_t callback,
+  void *context);
+
+#endif
\ No newline at end of file
@@ -77,6 +77,23 @@
 #define ARMCAT_INSTR_BKPT  0b01
 #define ARMCAT_INSTR_RFEDB 0x91
 
+/* Semantic flags of a decoded instruction! */
+#define ARMCAT_SEMANTIC_BRANCH      0x00000001 /* Transfers control. */
+#define ARMCAT_SEMANTIC_LOAD        0x00000002 /* Reads memory. */
+#define ARMCAT_SEMANTIC_STORE       0x00000004 /* Writes memory. */
+#define ARMCAT_SEMANTIC_WRITES_PC   0x00000008 /* Writes the program counter. */
+#define ARMCAT_SEMANTIC_CONDITIONAL 0x00000010 /* Only executes if its condition code passes. */
+#define ARMCAT_SEMANTIC_LINK        0x00000020 /* Writes the return address to lr. */
+#define ARMCAT_SEMANTIC_SETS_FLAGS  0x00000040 /* Updates the condition flags. */
+
+/* Operand roles of an opcode table entry, used to derive the register masks! */
+#define ARMCAT_SEMANTIC_READS_RN  0x00000100 /* Reads the register in bits 19:16. */
+#define ARMCAT_SEMANTIC_READS_RD  0x00000200 /* Reads the register in bits 15:12. */
+#define ARMCAT_SEMANTIC_WRITES_RD 0x00000400 /* Writes the register in bits 15:12. */
+
+/* Macro that turns a register number into its bit in a register mask! */
+#define ARMCAT_REGISTER_BIT(reg) ((uint16_t)(1u << ((reg) & 0xf)))
+
 
 /*
     *    src/instr.h
@@ -143,6 +160,10 @@ typedef struct _armcat_ldrstr_instr {
 /* Structure containing the disassembly data of an encoded instruction. */
 typedef struct _armcat_instr {
   uint32_t instr; /* The encoded instruction. */
+  uint16_t rmask; /* Bitmask of the registers read by the instruction. */
+  uint16_t wmask; /* Bitmask of the registers written by the instruction. */
+  uint32_t flags; /* The semantic flags. (ARMCAT_SEMANTIC_*) */
+  int32_t status; /* The disassembly status. (ARMCAT_STATUS_*) */
   char disasm_instr[ARMCAT_DISASM_INSTR_SIZEMAX]; /* The decoded and disassembled instruction. */
 } armcat_instr_t;
 
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#include "hash.h"
+#include "live.h"
+#include "disasm.h"
+
+#define ARMCAT_LIVE_PATH_SIZEMAX 32 /* Maximum size of a /proc/pid/mem path. */
+
+
+/*
+    *    src/live.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Reads the region of the process into the snapshot.
+ * @param live The watched region.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+static armcat_status_t live_read(armcat_live_t *live) {
+  size_t offset = 0;
+
+  /* process_vm_readv avoids a descriptor and a seek, but may be blocked by seccomp or missing, or stop short. */
+  if (live->fd == -1) {
+    while (offset < live->nbytes) {
+      const struct iovec local  = { .iov_base = live->snapshot + offset, .iov_len = live->nbytes - offset };
+      const struct iovec remote = { .iov_base = (void *)(uintptr_t)(live->address + offset), .iov_len = local.iov_len };
+
+      const ssize_t nbytes = process_vm_readv(live->pid, &local, 1, &remote, 1, 0);
+      if (nbytes <= 0)
+        break;
+
+      offset += nbytes;
+    }
+
+    if (offset == live->nbytes)
+      return ARMCAT_STATUS_SUCCESS;
+
+    if (errno == ESRCH)
+      return ARMCAT_STATUS_FAILURE;
+
+    char path[ARMCAT_LIVE_PATH_SIZEMAX] = {0};
+    snprintf(path, sizeof(path), "/proc/%d/mem", (int)live->pid);
+
+    if ((live->fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+      return ARMCAT_STATUS_FAILURE;
+  }
+
+  while (offset < live->nbytes) {
+    const ssize_t nbytes = pread(live->fd, live->snapshot + offset, live->nbytes - offset, live->address + offset);
+
+    if (nbytes == -1 && errno == EINTR)
+      continue;
+
+    if (nbytes <= 0)
+      return ARMCAT_STATUS_FAILURE;
+
+    offset += nbytes;
+  }
+
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the watched region.
+ * @param live The watched region.
+ */
+
+void armcat_live_free(armcat_live_t *live) {
+  if (live->fd != -1)
+    close(live->fd);
+
+  if (live->disassembly)
+    armcat_free(live->disassembly);
+
+  free(live->snapshot);
+  free(live->hashes);
+  free(live->dirty);
+  free(live);
+}
+
+/**
+ * @brief Creates a watched code region of a live process, the first refresh disassembles it entirely.
+ * @param pid The process.
+ * @param address The address of the region in the process.
+ * @param nbytes The size of the region.
+ * @returns The watched region, NULL on failure.
+ */
+
+armcat_live_t *armcat_live_create(const pid_t pid, const uint64_t address, const size_t nbytes) {
+  armcat_live_t *live = calloc(1, sizeof(armcat_live_t));
+  if (!live)
+    return NULL;
+
+  live->fd      = -1;
+  live->pid     = pid;
+  live->address = address;
+  live->nbytes  = nbytes;
+  live->npages  = (nbytes + ARMCAT_PAGE_SIZE - 1) / ARMCAT_PAGE_SIZE;
+
+  const size_t ninstr = nbytes / ARMCAT_INSTR_SIZEMAX;
+
+  /* The disassembly starts out empty rather than decoded, the first refresh decodes every page anyway. */
+  if (!(live->snapshot = calloc(nbytes + 1, 1)) || !(live->hashes = calloc(live->npages + 1, sizeof(uint64_t)))
+    || !(live->dirty = calloc((live->npages + 63) / 64 + 1, sizeof(uint64_t)))
+    || !(live->disassembly = calloc(1, sizeof(armcat_disasm_t)))
+    || !(live->disassembly->instructions = calloc(ninstr + 1, sizeof(armcat_instr_t)))
+    || !(live->disassembly->valid = calloc((ninstr + 63) / 64 + 1, sizeof(uint64_t))))
+  {
+    armcat_live_free(live);
+
+    return NULL;
+  }
+
+  live->disassembly->ninstr = ninstr;
+
+  /* Start from a hash no page is expected to have, so every page counts as changed at first. */
+  const uint64_t unseen = ~hash_buffer(live->snapshot, 0, 0);
+
+  for (size_t page = 0; page < live->npages; ++page)
+    live->hashes[page] = unseen;
+
+  return live;
+}
+
+/**
+ * @brief Takes a new snapshot of the region, re-disassembling only the pages whose hash changed.
+ * @param live The watched region.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure.
+ */
+
+armcat_status_t armcat_live_refresh(armcat_live_t *live) {
+  if (live_read(live) != ARMCAT_STATUS_SUCCESS)
+    return ARMCAT_STATUS_FAILURE;
+
+  armcat_disasm_t *disassembly = live->disassembly;
+
+  memset(live->dirty, 0, ((live->npages + 63) / 64) * sizeof(uint64_t));
+  live->nchanged = 0;
+
+  for (size_t page = 0; page < live->npages; ++page) {
+    const size_t offset = page * ARMCAT_PAGE_SIZE;
+    const size_t size   = (live->nbytes - offset < ARMCAT_PAGE_SIZE) ? live->nbytes - offset : ARMCAT_PAGE_SIZE;
+
+    /* A page is only compared with its own hash from the last refresh, a different one means it changed. */
+    const uint64_t hash = hash_buffer(live->snapshot + offset, size, 0);
+
+    if (hash == live->hashes[page])
+      continue;
+
+    live->hashes[page] = hash;
+    live->dirty[page >> 6] |= 1ull << (page & 63);
+    live->nchanged++;
+
+    const size_t first = offset / ARMCAT_INSTR_SIZEMAX;
+    const size_t last  = (offset + size) / ARMCAT_INSTR_SIZEMAX;
+
+    memset(&disassembly->instructions[first], 0, (last - first) * sizeof(armcat_instr_t));
+
+    for (size_t i = first; i < last; ++i) {
+      const armcat_status_t status = disasm_instr(&disassembly->instructions[i], 
+        *(uint32_t *)(live->snapshot + i * ARMCAT_INSTR_SIZEMAX));
+
+      disassembly->valid[i >> 6] = (disassembly->valid[i >> 6] & ~(1ull << (i & 63)))
+        | ((uint64_t)(status == ARMCAT_STATUS_SUCCESS) << (i & 63));
+    }
+  }
+
+  return ARMCAT_STATUS_SUCCESS;
+}
\ No newline at end of file
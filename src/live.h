@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __LIVE_H
+#define __LIVE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/types.h>
+
+#include "armcat.h"
+
+/* Macro that tests whether a page changed during the last refresh! */
+#define ARMCAT_LIVE_PAGE_CHANGED(live, page) (((live)->dirty[(page) >> 6] >> ((page) & 63)) & 1)
+
+
+/*
+    *    src/live.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing a watched code region of a live process. */
+typedef struct _armcat_live {
+  pid_t pid; /* The process. */
+  int fd; /* The /proc/pid/mem descriptor, opened when process_vm_readv is unavailable. */
+  uint64_t address; /* The address of the region in the process. */
+  size_t nbytes; /* The size of the region. */
+  size_t npages; /* The amount of ARMCAT_PAGE_SIZE pages in the region. */
+  size_t nchanged; /* The amount of pages that changed during the last refresh. */
+  uint8_t *snapshot; /* The contents of the region as of the last refresh. */
+  uint64_t *hashes; /* The hash of each page as of the last refresh. */
+  uint64_t *dirty; /* A bitmap of the pages that changed during the last refresh. */
+  armcat_disasm_t *disassembly; /* The disassembly of the region, kept up to date page by page. */
+} armcat_live_t;
+
+void armcat_live_free(armcat_live_t *live);
+armcat_live_t *armcat_live_create(const pid_t pid, const uint64_t address, const size_t nbytes);
+
+armcat_status_t armcat_live_refresh(armcat_live_t *live);
+
+#endif
\ No newline at end of file
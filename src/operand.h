@@ -19,9 +19,17 @@
 #ifndef __OPERAND_H
 #define __OPERAND_H
 
-#include <stdio.h>
 #include <stdint.h>
 
+#ifndef ARMCAT_FREESTANDING
+  #include <stdio.h>
+#endif
+
+/* Without libc headers nothing provides the glibc attribute shorthand. */
+#ifndef __always_inline
+  #define __always_inline __attribute__((always_inline))
+#endif
+
 
 /*
     *    src/operand.h
@@ -37,10 +45,8 @@
  * @returns Rotated immediate operand.
  */
 
-static inline __always_inline int operand_rotate(const int operand, const int rotate) {
-  return (
-    (operand & ((1 << (rotate * 2)) - 1)) << (32 - (rotate * 2))) | (operand >> (rotate * 2)
-  );
+static inline __always_inline uint32_t operand_rotate(const uint32_t operand, const uint32_t rotate) {
+  return (operand >> (rotate * 2)) | (operand << ((32 - (rotate * 2)) & 31));
 }
 
 /**
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+
+#include "hash.h"
+#include "disasm.h"
+#include "pagecache.h"
+
+#define ARMCAT_PAGECACHE_PATH_SIZEMAX 4096 /* Maximum size of the path of a cache entry. */
+
+
+/*
+    *    src/pagecache.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing the header of a cache entry, followed by the page words and the decoded instructions. */
+typedef struct _armcat_pagecache_header {
+  uint32_t magic; /* ARMCAT_PAGECACHE_MAGIC. */
+  uint32_t version; /* ARMCAT_PAGECACHE_VERSION. */
+  uint64_t key; /* The hash of the page. */
+  uint32_t ninstr; /* The amount of instructions in the page. */
+  uint32_t instr_size; /* The size of armcat_instr_t, so entries from another build are never misread. */
+} armcat_pagecache_header_t;
+
+/**
+ * @brief Builds the path of a cache entry, entries are spread over 256 subdirectories.
+ * @param cache The cache.
+ * @param path The path.
+ * @param key The hash of the page.
+ * @param subdirectory Whether to stop at the subdirectory.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE if the path does not fit.
+ */
+
+static armcat_status_t pagecache_path(const armcat_pagecache_t *cache, char *path, const uint64_t key,
+  const int subdirectory)
+{
+  const int length = subdirectory 
+    ? snprintf(path, ARMCAT_PAGECACHE_PATH_SIZEMAX, "%s/%02x", cache->path, (unsigned int)(key >> 56))
+    : snprintf(path, ARMCAT_PAGECACHE_PATH_SIZEMAX, "%s/%02x/%016llx", cache->path, (unsigned int)(key >> 56), 
+      (unsigned long long)key);
+
+  return (length > 0 && length < ARMCAT_PAGECACHE_PATH_SIZEMAX) ? ARMCAT_STATUS_SUCCESS : ARMCAT_STATUS_FAILURE;
+}
+
+/**
+ * @brief Loads a page from the cache.
+ * @param cache The cache.
+ * @param key The hash of the page.
+ * @param words The page contents, compared against the entry to rule out hash collisions.
+ * @param ninstr The amount of instructions in the page.
+ * @param instructions Receives the decoded instructions.
+ * @returns ARMCAT_STATUS_SUCCESS on a hit, ARMCAT_STATUS_FAILURE on a miss or an invalid entry.
+ */
+
+static armcat_status_t pagecache_load(const armcat_pagecache_t *cache, const uint64_t key, const uint8_t *words,
+  const size_t ninstr, armcat_instr_t *instructions)
+{
+  char path[ARMCAT_PAGECACHE_PATH_SIZEMAX] = {0};
+  if (pagecache_path(cache, path, key, 0) != ARMCAT_STATUS_SUCCESS)
+    return ARMCAT_STATUS_FAILURE;
+
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return ARMCAT_STATUS_FAILURE;
+
+  armcat_pagecache_header_t header = {0};
+  uint8_t stored[ARMCAT_PAGE_SIZE];
+
+  /* One read for the whole entry, the instructions land in place. */
+  const struct iovec iov[3] = {
+    { .iov_base = &header, .iov_len = sizeof(header) },
+    { .iov_base = stored, .iov_len = ninstr * ARMCAT_INSTR_SIZEMAX },
+    { .iov_base = instructions, .iov_len = ninstr * sizeof(armcat_instr_t) }
+  };
+
+  const ssize_t nbytes = readv(fd, iov, 3);
+  close(fd);
+
+  if (nbytes != (ssize_t)(iov[0].iov_len + iov[1].iov_len + iov[2].iov_len) || header.magic != ARMCAT_PAGECACHE_MAGIC
+    || header.version != ARMCAT_PAGECACHE_VERSION || header.key != key || header.ninstr != ninstr 
+    || header.instr_size != sizeof(armcat_instr_t) || memcmp(stored, words, ninstr * ARMCAT_INSTR_SIZEMAX))
+    return ARMCAT_STATUS_FAILURE;
+
+  /* The cache directory is trusted, these checks only keep a damaged record from being read out of bounds. */
+  for (size_t i = 0; i < ninstr; ++i)
+    if (instructions[i].instr != *(uint32_t *)(words + i * ARMCAT_INSTR_SIZEMAX)
+      || (instructions[i].status != ARMCAT_STATUS_SUCCESS && instructions[i].status != ARMCAT_STATUS_FAILURE)
+      || !memchr(instructions[i].disasm_instr, '\0', ARMCAT_DISASM_INSTR_SIZEMAX))
+      return ARMCAT_STATUS_FAILURE;
+
+  return ARMCAT_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Stores a decoded page in the cache, entries are written to a temporary file and renamed into place.
+ * @param cache The cache.
+ * @param key The hash of the page.
+ * @param words The page contents.
+ * @param ninstr The amount of instructions in the page.
+ * @param instructions The decoded instructions.
+ */
+
+static void pagecache_store(const armcat_pagecache_t *cache, const uint64_t key, const uint8_t *words,
+  const size_t ninstr, const armcat_instr_t *instructions)
+{
+  char path[ARMCAT_PAGECACHE_PATH_SIZEMAX] = {0}, temporary[ARMCAT_PAGECACHE_PATH_SIZEMAX] = {0};
+
+  if (pagecache_path(cache, path, key, 1) != ARMCAT_STATUS_SUCCESS || (mkdir(path, 0700) == -1 && errno != EEXIST))
+    return;
+
+  const int length = snprintf(temporary, sizeof(temporary), "%s/.tmp.XXXXXX", path);
+  if (length <= 0 || length >= (int)sizeof(temporary) || pagecache_path(cache, path, key, 0) != ARMCAT_STATUS_SUCCESS)
+    return;
+
+  const int fd = mkstemp(temporary);
+  if (fd == -1)
+    return;
+
+  const armcat_pagecache_header_t header = {
+    .magic      = ARMCAT_PAGECACHE_MAGIC,
+    .version    = ARMCAT_PAGECACHE_VERSION,
+    .key        = key,
+    .ninstr     = ninstr,
+    .instr_size = sizeof(armcat_instr_t)
+  };
+
+  const struct iovec iov[3] = {
+    { .iov_base = (void *)&header, .iov_len = sizeof(header) },
+    { .iov_base = (void *)words, .iov_len = ninstr * ARMCAT_INSTR_SIZEMAX },
+    { .iov_base = (void *)instructions, .iov_len = ninstr * sizeof(armcat_instr_t) }
+  };
+
+  /* Concurrent writers of the same page produce identical entries, whichever rename lands last wins. */
+  const ssize_t nbytes = writev(fd, iov, 3);
+
+  if (close(fd) || nbytes != (ssize_t)(iov[0].iov_len + iov[1].iov_len + iov[2].iov_len) 
+    || rename(temporary, path) == -1)
+    unlink(temporary);
+}
+
+/**
+ * @brief Closes the cache, the entries stay on disk.
+ * @param cache The cache.
+ */
+
+void armcat_pagecache_close(armcat_pagecache_t *cache) {
+  free(cache->path);
+  free(cache);
+}
+
+/**
+ * @brief Opens (and creates) a cache directory, only the caller's user may write to it.
+ * @param path The cache directory, its entries are trusted.
+ * @param options Any caller options that change the decoded output, pages decoded with other options never match.
+ * @returns The cache, NULL on failure.
+ */
+
+armcat_pagecache_t *armcat_pagecache_open(const char *path, const uint64_t options) {
+  if (mkdir(path, 0700) == -1 && errno != EEXIST)
+    return NULL;
+
+  armcat_pagecache_t *cache = calloc(1, sizeof(armcat_pagecache_t));
+  if (!cache)
+    return NULL;
+
+  if (!(cache->path = strdup(path))) {
+    free(cache);
+    return NULL;
+  }
+
+  cache->seed = hash_mix(((uint64_t)ARMCAT_PAGECACHE_VERSION << 32 | sizeof(armcat_instr_t)) ^ hash_mix(options));
+
+  return cache;
+}
+
+/**
+ * @brief Disassembles a given buffer page by page, loading pages seen before from the cache.
+ * @param cache The cache.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @returns A struct containing the disassembly data, identical to the one armcat_disasm returns.
+ */
+
+armcat_disasm_t *armcat_disasm_cached(armcat_pagecache_t *cache, const void *buffer, const size_t nbytes) {
+  armcat_disasm_t *disassembly = calloc(1, sizeof(armcat_disasm_t));
+  if (!disassembly)
+    return NULL;
+
+  if (!(disassembly->instructions = calloc((disassembly->ninstr = (nbytes / ARMCAT_INSTR_SIZEMAX)) + 1, 
+    sizeof(armcat_instr_t))) || !(disassembly->valid = calloc((disassembly->ninstr + 63) / 64 + 1, sizeof(uint64_t))))
+  {
+    armcat_free(disassembly);
+
+    return NULL;
+  }
+
+  for (size_t first = 0; first < disassembly->ninstr; first += ARMCAT_PAGECACHE_PAGE_INSTR) {
+    const size_t ninstr = (disassembly->ninstr - first < ARMCAT_PAGECACHE_PAGE_INSTR) 
+      ? disassembly->ninstr - first : ARMCAT_PAGECACHE_PAGE_INSTR;
+
+    const uint8_t *words = (const uint8_t *)buffer + first * ARMCAT_INSTR_SIZEMAX;
+    armcat_instr_t *instructions = &disassembly->instructions[first];
+
+    const uint64_t key = hash_buffer(words, ninstr * ARMCAT_INSTR_SIZEMAX, cache->seed);
+
+    if (pagecache_load(cache, key, words, ninstr, instructions) == ARMCAT_STATUS_SUCCESS)
+      cache->hits++;
+    else {
+      memset(instructions, 0, ninstr * sizeof(armcat_instr_t));
+
+      for (size_t i = 0; i < ninstr; ++i)
+        disasm_instr(&instructions[i], *(uint32_t *)(words + i * ARMCAT_INSTR_SIZEMAX));
+
+      pagecache_store(cache, key, words, ninstr, instructions);
+      cache->misses++;
+    }
+
+    for (size_t i = first; i < first + ninstr; ++i)
+      disassembly->valid[i >> 6] |= (uint64_t)(disassembly->instructions[i].status == ARMCAT_STATUS_SUCCESS) << (i & 63);
+  }
+
+  return disassembly;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __PAGECACHE_H
+#define __PAGECACHE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_PAGECACHE_MAGIC      0x50434D41 /* "AMCP", the magic of a cache entry. */
+#define ARMCAT_PAGECACHE_VERSION    1 /* The entry format, bumped whenever the decoded output changes. */
+#define ARMCAT_PAGECACHE_PAGE_INSTR (ARMCAT_PAGE_SIZE / ARMCAT_INSTR_SIZEMAX) /* Instructions per page. */
+
+
+/*
+    *    src/pagecache.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing a persistent on-disk cache of decoded pages, keyed by content hash. */
+typedef struct _armcat_pagecache {
+  char *path; /* The cache directory. */
+  uint64_t seed; /* The hash seed, derived from the format version and the options. */
+  size_t hits; /* The amount of pages found in the cache. */
+  size_t misses; /* The amount of pages that had to be decoded. */
+} armcat_pagecache_t;
+
+void armcat_pagecache_close(armcat_pagecache_t *cache);
+armcat_pagecache_t *armcat_pagecache_open(const char *path, const uint64_t options);
+
+armcat_disasm_t *armcat_disasm_cached(armcat_pagecache_t *cache, const void *buffer, const size_t nbytes);
+
+#endif
\ No newline at end of file
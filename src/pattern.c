@@ -0,0 +1,600 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "decode.h"
+#include "disasm.h"
+#include "pattern.h"
+
+#define ARMCAT_PATTERN_TABLE_FIELDS  5 /* Encoding fields the candidate tables are split on. */
+#define ARMCAT_PATTERN_TABLE_ENTRIES 800 /* Entries of all candidate tables, 16 + 256 + 256 + 256 + 16. */
+#define ARMCAT_PATTERN_NAMES_MAX     8 /* Distinct mnemonics kept per opcode byte, a byte with more matches any. */
+
+#define ARMCAT_PATTERN_MEMO_BITS  17 /* The failed search table holds twice ARMCAT_PATTERN_SEARCH_MAX slots. */
+#define ARMCAT_PATTERN_MEMO_SLOTS (1u << ARMCAT_PATTERN_MEMO_BITS)
+
+/* Macro that tests a state in a bitset! */
+#define ARMCAT_PATTERN_TEST(bitset, state) (((bitset)[(state) >> 6] >> ((state) & 63)) & 1)
+
+
+/*
+    *    src/pattern.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Offsets, widths and first table entries of the encoding fields, bits 27:20 being the opcode byte! */
+static const uint8_t field_offsets[ARMCAT_PATTERN_TABLE_FIELDS] = { 28, 20, 12, 4, 0 };
+static const uint8_t field_widths[ARMCAT_PATTERN_TABLE_FIELDS]  = { 4, 8, 8, 8, 4 };
+static const uint16_t field_bases[ARMCAT_PATTERN_TABLE_FIELDS]  = { 0, 16, 272, 528, 784 };
+
+/* Offsets of the register fields a step can bind, in ARMCAT_PATTERN_FIELD_* order! */
+static const uint8_t binding_offsets[ARMCAT_PATTERN_FIELDS] = { 16, 12, 8, 0 };
+
+/**
+ * @brief Looks up the candidate bitset of a value of an encoding field.
+ * @param set The pattern set.
+ * @param field The encoding field.
+ * @param instr The encoded instruction.
+ * @returns The candidate bitset.
+ */
+
+static inline __always_inline const uint64_t *pattern_table(const armcat_patternset_t *set, const size_t field,
+  const uint32_t instr)
+{
+  const uint32_t value = (instr >> field_offsets[field]) & ((1u << field_widths[field]) - 1);
+
+  return &set->tables[(field_bases[field] + value) * set->nwords];
+}
+
+/**
+ * @brief Checks a mnemonic against the one the disassembler prints for an encoding, with or without its condition.
+ * @param mnemonic The mnemonic.
+ * @param instr The encoded instruction.
+ * @returns 1 if the disassembler prints the mnemonic, 0 if otherwise.
+ */
+
+static int pattern_mnemonic(const char *mnemonic, const uint32_t instr) {
+  armcat_instr_t decoded = {0};
+  disasm_instr(&decoded, instr);
+
+  const char *text = decoded.disasm_instr, *condition = ARMCAT_CONDITION_NAME(instr >> 28);
+  const size_t length = strlen(mnemonic), token = strcspn(text, "\t");
+
+  if (strncmp(text, mnemonic, length))
+    return 0;
+
+  return token == length || (token == length + strlen(condition) && !strncmp(&text[length], condition, token - length));
+}
+
+/**
+ * @brief Collects the mnemonics the disassembler prints for each opcode byte, decoding representative encodings.
+ * @param names Receives the distinct mnemonics of each opcode byte.
+ * @param counts Receives the amount of mnemonics of each opcode byte, above ARMCAT_PATTERN_NAMES_MAX if there are more.
+ */
+
+static void pattern_names(char (*names)[ARMCAT_PATTERN_NAMES_MAX][ARMCAT_PATTERN_MNEMONIC_SIZEMAX], uint8_t *counts) {
+  /* Conditions AL and NV print no suffix, bits 7:4 select the encoding classes sharing an opcode byte. */
+  static const uint32_t fills[] = { 0x00000000, 0x000fff0f };
+
+  for (uint32_t opcode = 0; opcode < 256; ++opcode)
+    for (uint32_t condition = 0xe; condition <= 0xf; ++condition)
+      for (uint32_t bits = 0; bits < 16; ++bits)
+        for (size_t fill = 0; fill < sizeof(fills) / sizeof(fills[0]); ++fill) {
+          armcat_instr_t decoded = {0};
+          disasm_instr(&decoded, (condition << 28) | (opcode << 20) | (bits << 4) | fills[fill]);
+
+          char name[ARMCAT_PATTERN_MNEMONIC_SIZEMAX] = {0};
+          const size_t length = strcspn(decoded.disasm_instr, "\t");
+
+          if (!length || length >= sizeof(name) || counts[opcode] > ARMCAT_PATTERN_NAMES_MAX)
+            continue;
+
+          memcpy(name, decoded.disasm_instr, length);
+
+          size_t n = 0;
+          while (n < counts[opcode] && strcmp(names[opcode][n], name))
+            ++n;
+
+          if (n == counts[opcode] && counts[opcode]++ < ARMCAT_PATTERN_NAMES_MAX)
+            memcpy(names[opcode][n], name, sizeof(name));
+        }
+}
+
+/**
+ * @brief Checks whether the disassembler may print a mnemonic for an opcode byte.
+ * @param names The mnemonics of each opcode byte.
+ * @param counts The amount of mnemonics of each opcode byte.
+ * @param mnemonic The mnemonic.
+ * @param opcode The opcode byte. (bits 27:20)
+ * @returns 1 if it may, 0 if otherwise.
+ */
+
+static int pattern_named(char (*names)[ARMCAT_PATTERN_NAMES_MAX][ARMCAT_PATTERN_MNEMONIC_SIZEMAX], const uint8_t *counts,
+  const char *mnemonic, const uint32_t opcode)
+{
+  if (counts[opcode] > ARMCAT_PATTERN_NAMES_MAX)
+    return 1;
+
+  for (size_t n = 0; n < counts[opcode]; ++n)
+    if (!strcmp(names[opcode][n], mnemonic))
+      return 1;
+
+  return 0;
+}
+
+/**
+ * @brief Looks up a failed search, recording it if it is new.
+ * @param memo The failed search table.
+ * @param key The search.
+ * @param record Whether to record the search.
+ * @returns 1 if the search already failed, 0 if otherwise.
+ */
+
+static int pattern_memo(armcat_pattern_memo_t *memo, const uint64_t key, const int record) {
+  for (size_t slot = (key * 0x9e3779b97f4a7c15ull) >> (64 - ARMCAT_PATTERN_MEMO_BITS);;
+    slot = (slot + 1) & (ARMCAT_PATTERN_MEMO_SLOTS - 1))
+  {
+    if (memo->generations[slot] != memo->generation) {
+      if (record) {
+        memo->generations[slot] = memo->generation;
+        memo->keys[slot] = key;
+      }
+
+      return 0;
+    }
+
+    if (memo->keys[slot] == key)
+      return 1;
+  }
+}
+
+/**
+ * @brief Matches a pattern backwards from one of its states, binding registers and locating the first step.
+ * @param set The pattern set.
+ * @param buffer The buffer.
+ * @param state The state.
+ * @param index The instruction that must match the state.
+ * @param variables The registers bound so far, -1 for unbound variables.
+ * @param start Receives the first instruction of the match.
+ * @param memo The searches that already failed for this match.
+ * @returns 1 if the pattern matches, 0 if otherwise.
+ */
+
+static int pattern_verify(const armcat_patternset_t *set, const uint8_t *buffer, const size_t state,
+  const size_t index, int8_t *variables, size_t *start, armcat_pattern_memo_t *memo)
+{
+  const armcat_pattern_state_t *step = &set->states[state];
+  const uint32_t instr = *(uint32_t *)(buffer + index * ARMCAT_INSTR_SIZEMAX);
+
+  for (size_t field = 0; field < ARMCAT_PATTERN_TABLE_FIELDS; ++field)
+    if (!ARMCAT_PATTERN_TEST(pattern_table(set, field, instr), state))
+      return 0;
+
+  /* Whether the earlier steps can match only depends on where this one is and on the bindings they share. */
+  uint64_t key = 0;
+
+  for (size_t variable = 0; variable < ARMCAT_PATTERN_VARIABLES; ++variable)
+    if ((step->relevant >> variable) & 1)
+      key = key * 17 + (uint64_t)(variables[variable] + 1);
+
+  key = (key << 12) | ((memo->last - index) << 6) | (state - step->first);
+
+  if (pattern_memo(memo, key, 0))
+    return 0;
+
+  if (step->mnemonic[0] && !pattern_mnemonic(step->mnemonic, instr))
+    return pattern_memo(memo, key, 1);
+
+  int8_t saved[ARMCAT_PATTERN_VARIABLES];
+  memcpy(saved, variables, sizeof(saved));
+
+  for (size_t field = 0; field < ARMCAT_PATTERN_FIELDS; ++field) {
+    const int8_t variable = step->bindings[field];
+    const int8_t reg = (instr >> binding_offsets[field]) & 0xf;
+
+    if (variable == ARMCAT_PATTERN_UNBOUND)
+      continue;
+
+    if (variables[variable] != -1 && variables[variable] != reg) {
+      memcpy(variables, saved, sizeof(saved));
+      return pattern_memo(memo, key, 1);
+    }
+
+    variables[variable] = reg;
+  }
+
+  if (state == step->first) {
+    *start = index;
+    return 1;
+  }
+
+  for (size_t skipped = 0; skipped <= step->gap && skipped < index; ++skipped)
+    if (pattern_verify(set, buffer, state - 1 - step->gap, index - 1 - skipped, variables, start, memo))
+      return 1;
+
+  memcpy(variables, saved, sizeof(saved));
+  return pattern_memo(memo, key, 1);
+}
+
+/**
+ * @brief Computes the variables a step binds.
+ * @param step The step.
+ * @returns The variables, one bit each.
+ */
+
+static inline __always_inline uint8_t pattern_bound(const armcat_pattern_step_t *step) {
+  uint8_t bound = 0;
+
+  for (size_t field = 0; field < ARMCAT_PATTERN_FIELDS; ++field)
+    if (step->bindings[field] != ARMCAT_PATTERN_UNBOUND)
+      bound |= 1u << step->bindings[field];
+
+  return bound;
+}
+
+/**
+ * @brief Computes the variables that are bound both up to a step and after it.
+ * @param pattern The pattern.
+ * @param k The step.
+ * @returns The variables, one bit each.
+ */
+
+static uint8_t pattern_relevant(const armcat_pattern_t *pattern, const size_t k) {
+  uint8_t earlier = 0, later = 0;
+
+  for (size_t j = 0; j < pattern->nsteps; ++j)
+    *((j <= k) ? &earlier : &later) |= pattern_bound(&pattern->steps[j]);
+
+  return earlier & later;
+}
+
+/**
+ * @brief Bounds the steps verifying a match of a pattern tries, the failed searches of a step being memoized.
+ * @param pattern The pattern.
+ * @returns The bound, saturating above ARMCAT_PATTERN_SEARCH_MAX.
+ */
+
+static uint64_t pattern_cost(const armcat_pattern_t *pattern) {
+  uint64_t cost = 1, paths = 1, window = 1;
+
+  /* Verification walks backwards, a step being searched once per path to it or once per distinct search. */
+  for (size_t k = pattern->nsteps; k-- > 0 && cost <= ARMCAT_PATTERN_SEARCH_MAX;) {
+    const uint64_t gap = k ? pattern->steps[k].gap : 0;
+    uint64_t searches = window;
+
+    for (uint8_t relevant = pattern_relevant(pattern, k); relevant; relevant &= relevant - 1)
+      searches *= 17;
+
+    cost   += ((paths < searches) ? paths : searches) * (gap + 1);
+    paths  *= gap + 1;
+    window += gap;
+
+    if (paths > ARMCAT_PATTERN_SEARCH_MAX)
+      paths = ARMCAT_PATTERN_SEARCH_MAX + 1;
+  }
+
+  return cost;
+}
+
+/**
+ * @brief Computes the amount of states a pattern needs, one per step and one per instruction of each gap.
+ * @param pattern The pattern.
+ * @returns The amount of states, 0 if the pattern is invalid or too costly to verify.
+ */
+
+static size_t pattern_span(const armcat_pattern_t *pattern) {
+  size_t span = pattern->nsteps;
+
+  for (size_t k = 0; k < pattern->nsteps; ++k) {
+    const armcat_pattern_step_t *step = &pattern->steps[k];
+
+    if (step->mnemonic && (!step->mnemonic[0] || strlen(step->mnemonic) >= ARMCAT_PATTERN_MNEMONIC_SIZEMAX))
+      return 0;
+
+    for (size_t field = 0; field < ARMCAT_PATTERN_FIELDS; ++field)
+      if (step->bindings[field] < ARMCAT_PATTERN_UNBOUND || step->bindings[field] >= ARMCAT_PATTERN_VARIABLES)
+        return 0;
+
+    span += k ? step->gap : 0;
+  }
+
+  return (span <= ARMCAT_PATTERN_SPAN_MAX && pattern_cost(pattern) <= ARMCAT_PATTERN_SEARCH_MAX) ? span : 0;
+}
+
+/**
+ * @brief Places a pattern in the state bitset, moving it to the next word if it would cross one.
+ * @param state The next free state.
+ * @param span The amount of states of the pattern.
+ * @returns The first state of the pattern.
+ */
+
+static inline __always_inline size_t pattern_place(const size_t state, const size_t span) {
+  return ((state & 63) + span > 64) ? (state + 63) & ~(size_t)63 : state;
+}
+
+/**
+ * @brief Marks a state as a candidate for a value of an encoding field.
+ * @param set The pattern set.
+ * @param entry The table entry.
+ * @param state The state.
+ */
+
+static inline __always_inline void pattern_mark(armcat_patternset_t *set, const size_t entry, const size_t state) {
+  set->tables[entry * set->nwords + (state >> 6)] |= 1ull << (state & 63);
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the pattern set.
+ * @param set The pattern set.
+ */
+
+void armcat_pattern_free(armcat_patternset_t *set) {
+  free(set->states);
+  free(set->tables);
+  free(set->summary);
+  free(set->initial);
+  free(set->final);
+  free(set->gap_enter);
+  free(set->gap_exit);
+  free(set->gap_states);
+  free(set);
+}
+
+/**
+ * @brief Compiles patterns into one Shift-And automaton, each step and each instruction of a gap becoming a state.
+ * @param patterns The patterns.
+ * @param npatterns The amount of patterns.
+ * @returns The pattern set, NULL if a pattern is invalid or on failure.
+ */
+
+armcat_patternset_t *armcat_pattern_compile(const armcat_pattern_t *patterns, const size_t npatterns) {
+  size_t nstates = 0;
+
+  for (size_t p = 0; p < npatterns; ++p) {
+    const size_t span = pattern_span(&patterns[p]);
+
+    if (!span)
+      return NULL;
+
+    nstates = pattern_place(nstates, span) + span;
+  }
+
+  armcat_patternset_t *set = calloc(1, sizeof(armcat_patternset_t));
+  if (!set)
+    return NULL;
+
+  set->npatterns = npatterns;
+  set->nwords    = (nstates + 63) / 64 + !nstates;
+  set->nsummary  = (set->nwords + 63) / 64;
+
+  const size_t nwords = set->nwords;
+
+  char (*names)[ARMCAT_PATTERN_NAMES_MAX][ARMCAT_PATTERN_MNEMONIC_SIZEMAX] = calloc(256, sizeof(*names));
+  uint8_t counts[256] = {0};
+
+  if (!names || !(set->states = calloc(nwords * 64, sizeof(armcat_pattern_state_t)))
+    || !(set->tables = calloc(ARMCAT_PATTERN_TABLE_ENTRIES * nwords, sizeof(uint64_t)))
+    || !(set->summary = calloc(256 * set->nsummary, sizeof(uint64_t)))
+    || !(set->initial = calloc(nwords, sizeof(uint64_t))) || !(set->final = calloc(nwords, sizeof(uint64_t)))
+    || !(set->gap_enter = calloc(nwords, sizeof(uint64_t))) || !(set->gap_exit = calloc(nwords, sizeof(uint64_t)))
+    || !(set->gap_states = calloc(nwords, sizeof(uint64_t))))
+  {
+    armcat_pattern_free(set);
+    free(names);
+
+    return NULL;
+  }
+
+  pattern_names(names, counts);
+
+  for (size_t p = 0, state = 0; p < npatterns; ++p) {
+    const size_t first = state = pattern_place(state, pattern_span(&patterns[p]));
+
+    for (size_t k = 0; k < patterns[p].nsteps; ++k, ++state) {
+      const armcat_pattern_step_t *step = &patterns[p].steps[k];
+      const uint8_t gap = k ? step->gap : 0;
+
+      /* Each instruction a gap may skip is a wildcard state, matching any encoding. */
+      if (gap) {
+        set->gap_enter[(state - 1) >> 6] |= 1ull << ((state - 1) & 63);
+
+        for (size_t j = 0; j < gap; ++j, ++state) {
+          set->gap_states[state >> 6] |= 1ull << (state & 63);
+
+          for (size_t entry = 0; entry < ARMCAT_PATTERN_TABLE_ENTRIES; ++entry)
+            pattern_mark(set, entry, state);
+        }
+
+        set->gap_exit[(state - 1) >> 6] |= 1ull << ((state - 1) & 63);
+      }
+
+      set->states[state] = (armcat_pattern_state_t){
+        .mask     = step->mask,
+        .value    = step->value & step->mask,
+        .pattern  = p,
+        .first    = first,
+        .gap      = gap,
+        .relevant = pattern_relevant(&patterns[p], k)
+      };
+
+      memcpy(set->states[state].bindings, step->bindings, sizeof(step->bindings));
+
+      if (step->mnemonic)
+        strcpy(set->states[state].mnemonic, step->mnemonic);
+
+      if (!k)
+        set->initial[state >> 6] |= 1ull << (state & 63);
+      if (k + 1 == patterns[p].nsteps)
+        set->final[state >> 6] |= 1ull << (state & 63);
+
+      /* Mask/value constraints split exactly over the fields, the mnemonic narrows the opcode byte. */
+      int matched = 0;
+
+      for (size_t field = 0; field < ARMCAT_PATTERN_TABLE_FIELDS; ++field) {
+        const uint32_t width = (1u << field_widths[field]) - 1;
+        const uint32_t mask  = (set->states[state].mask >> field_offsets[field]) & width;
+        const uint32_t value = (set->states[state].value >> field_offsets[field]) & width;
+
+        for (uint32_t entry = 0; entry <= width; ++entry) {
+          if ((entry & mask) != value || (field == 1 && step->mnemonic && !pattern_named(names, counts, step->mnemonic, entry)))
+            continue;
+
+          pattern_mark(set, field_bases[field] + entry, state);
+          matched |= (field == 1);
+        }
+      }
+
+      /* An unknown mnemonic (or one the mask rules out) would make the pattern unmatchable. */
+      if (!matched) {
+        armcat_pattern_free(set);
+        free(names);
+
+        return NULL;
+      }
+    }
+  }
+
+  for (size_t opcode = 0; opcode < 256; ++opcode)
+    for (size_t k = 0; k < nwords; ++k)
+      if (set->tables[(field_bases[1] + opcode) * nwords + k] & set->initial[k])
+        set->summary[opcode * set->nsummary + (k >> 6)] |= 1ull << (k & 63);
+
+  free(names);
+  return set;
+}
+
+/**
+ * @brief Verifies a match ending at an instruction, decoding it and passing it to the callback.
+ * @param set The pattern set.
+ * @param buffer The buffer.
+ * @param state The final state that was reached.
+ * @param index The last instruction of the match.
+ * @param base The address of the buffer.
+ * @param instructions The scratch array the match is decoded into.
+ * @param memo The failed search table.
+ * @param callback The callback.
+ * @param context The context passed to the callback.
+ * @returns ARMCAT_STATUS_FAILURE if the callback fails, ARMCAT_STATUS_SUCCESS if otherwise.
+ */
+
+static armcat_status_t pattern_report(const armcat_patternset_t *set, const uint8_t *buffer, const size_t state,
+  const size_t index, const uint32_t base, armcat_instr_t *instructions, armcat_pattern_memo_t *memo,
+  armcat_pattern_callback_t callback, void *context)
+{
+  int8_t variables[ARMCAT_PATTERN_VARIABLES];
+  memset(variables, -1, sizeof(variables));
+
+  /* A new generation empties the failed search table, the slots only being cleared when it wraps. */
+  if (!++memo->generation) {
+    memset(memo->generations, 0, ARMCAT_PATTERN_MEMO_SLOTS * sizeof(uint32_t));
+    memo->generation = 1;
+  }
+
+  memo->last = index;
+
+  size_t start = index;
+  if (!pattern_verify(set, buffer, state, index, variables, &start, memo))
+    return ARMCAT_STATUS_SUCCESS;
+
+  memset(instructions, 0, (index - start + 1) * sizeof(armcat_instr_t));
+
+  for (size_t j = start; j <= index; ++j)
+    disasm_instr(&instructions[j - start], *(uint32_t *)(buffer + j * ARMCAT_INSTR_SIZEMAX));
+
+  return callback(context, set->states[state].pattern, base + start * ARMCAT_INSTR_SIZEMAX, instructions,
+    index - start + 1);
+}
+
+/**
+ * @brief Scans a buffer for every pattern of a set in a single pass, decoding only the matches.
+ * @param set The pattern set.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @param base The address of the buffer.
+ * @param callback The callback receiving each match, called once per pattern and last instruction.
+ * @param context The context passed to the callback.
+ * @returns ARMCAT_STATUS_SUCCESS on success, ARMCAT_STATUS_FAILURE on failure or if the callback fails.
+ */
+
+armcat_status_t armcat_pattern_scan(const armcat_patternset_t *set, const void *buffer, const size_t nbytes,
+  const uint32_t base, armcat_pattern_callback_t callback, void *context)
+{
+  const size_t ninstr = nbytes / ARMCAT_INSTR_SIZEMAX, nwords = set->nwords, nsummary = set->nsummary;
+
+  uint64_t *active = calloc(nwords, sizeof(uint64_t)), *occupied = calloc(nsummary, sizeof(uint64_t));
+  armcat_instr_t *instructions = malloc(ARMCAT_PATTERN_SPAN_MAX * sizeof(armcat_instr_t));
+
+  armcat_pattern_memo_t memo = {
+    .keys        = malloc(ARMCAT_PATTERN_MEMO_SLOTS * sizeof(uint64_t)),
+    .generations = calloc(ARMCAT_PATTERN_MEMO_SLOTS, sizeof(uint32_t))
+  };
+
+  if (!active || !occupied || !instructions || !memo.keys || !memo.generations) {
+    free(active);
+    free(occupied);
+    free(instructions);
+    free(memo.keys);
+    free(memo.generations);
+
+    return ARMCAT_STATUS_FAILURE;
+  }
+
+  armcat_status_t status = ARMCAT_STATUS_SUCCESS;
+
+  for (size_t i = 0; i < ninstr && status == ARMCAT_STATUS_SUCCESS; ++i) {
+    const uint32_t instr = *(uint32_t *)(buffer + i * ARMCAT_INSTR_SIZEMAX);
+
+    const uint64_t *cond   = pattern_table(set, 0, instr), *opcode = pattern_table(set, 1, instr);
+    const uint64_t *middle = pattern_table(set, 2, instr), *shift  = pattern_table(set, 3, instr);
+    const uint64_t *rm     = pattern_table(set, 4, instr);
+
+    /* Only words holding partial matches, or states the opcode byte can start or advance, need work. */
+    const uint64_t *summary = &set->summary[((instr >> 20) & 0xff) * nsummary];
+
+    for (size_t j = 0; j < nsummary && status == ARMCAT_STATUS_SUCCESS; ++j)
+      for (uint64_t pending = summary[j] | occupied[j]; pending; pending &= pending - 1) {
+        const size_t k = j * 64 + __builtin_ctzll(pending);
+
+        uint64_t next = ((active[k] << 1) | set->initial[k]) & opcode[k];
+
+        /* The opcode byte rules out most states, so the other rows are rarely touched. */
+        if (next)
+          next &= cond[k] & middle[k] & shift[k] & rm[k];
+
+        /* A state preceding a gap enables every wildcard state of the gap, the borrow stopping at its last one. */
+        const uint64_t closed = next | set->gap_exit[k];
+        next |= set->gap_states[k] & ~((closed - set->gap_enter[k]) ^ closed);
+
+        active[k] = next;
+        occupied[j] = next ? occupied[j] | (pending & -pending) : occupied[j] & ~(pending & -pending);
+
+        for (uint64_t hits = next & set->final[k]; hits && status == ARMCAT_STATUS_SUCCESS; hits &= hits - 1)
+          status = pattern_report(set, buffer, k * 64 + __builtin_ctzll(hits), i, base, instructions, &memo,
+            callback, context);
+      }
+  }
+
+  free(active);
+  free(occupied);
+  free(instructions);
+  free(memo.keys);
+  free(memo.generations);
+
+  return status;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __PATTERN_H
+#define __PATTERN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_PATTERN_VARIABLES 8 /* Register variables a pattern can bind. */
+#define ARMCAT_PATTERN_SPAN_MAX  64 /* Maximum amount of instructions a match can span, one state word. */
+#define ARMCAT_PATTERN_SEARCH_MAX (1 << 16) /* Maximum steps tried to verify a match, costlier patterns are rejected. */
+
+#define ARMCAT_PATTERN_MNEMONIC_SIZEMAX 8 /* Maximum size of a mnemonic, including the terminator. */
+
+/* Register fields a step can bind to a variable! */
+#define ARMCAT_PATTERN_FIELD_RN 0 /* Bits 19:16. */
+#define ARMCAT_PATTERN_FIELD_RD 1 /* Bits 15:12. */
+#define ARMCAT_PATTERN_FIELD_RS 2 /* Bits 11:8. */
+#define ARMCAT_PATTERN_FIELD_RM 3 /* Bits 3:0. */
+#define ARMCAT_PATTERN_FIELDS   4
+
+#define ARMCAT_PATTERN_UNBOUND -1 /* The field is not bound to a variable. */
+
+
+/*
+    *    src/pattern.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing the constraints on a single instruction of a pattern. */
+typedef struct _armcat_pattern_step {
+  uint32_t mask; /* The bits that must equal value. */
+  uint32_t value; /* The expected value of the masked bits. */
+  const char *mnemonic; /* The mnemonic as printed by the disassembler without its condition, NULL for any. */
+  uint8_t gap; /* The maximum amount of other instructions allowed before this step. */
+  int8_t bindings[ARMCAT_PATTERN_FIELDS]; /* The variable each register field is bound to. (ARMCAT_PATTERN_UNBOUND) */
+} armcat_pattern_step_t;
+
+/* Structure containing a pattern, a sequence of steps. */
+typedef struct _armcat_pattern {
+  const armcat_pattern_step_t *steps; /* The steps. */
+  size_t nsteps; /* The amount of steps. */
+} armcat_pattern_t;
+
+/* Structure containing a step once compiled into an automaton state. */
+typedef struct _armcat_pattern_state {
+  uint32_t mask; /* The bits that must equal value. */
+  uint32_t value; /* The expected value of the masked bits. */
+  uint32_t pattern; /* The pattern the state belongs to. */
+  uint32_t first; /* The state of the first step of the pattern. */
+  uint8_t gap; /* The maximum amount of other instructions allowed before this step, one wildcard state each. */
+  uint8_t relevant; /* The variables bound both up to this step and after it, the only ones a failure depends on. */
+  int8_t bindings[ARMCAT_PATTERN_FIELDS]; /* The variable each register field is bound to. */
+  char mnemonic[ARMCAT_PATTERN_MNEMONIC_SIZEMAX]; /* The mnemonic, empty for any. */
+} armcat_pattern_state_t;
+
+/* Structure containing a set of patterns compiled into a single bit-parallel automaton. */
+typedef struct _armcat_patternset {
+  size_t npatterns; /* The amount of patterns. */
+  size_t nwords; /* The amount of 64-bit words in a state bitset, no pattern crosses a word. */
+  size_t nsummary; /* The amount of 64-bit words in a bitmap of state words. */
+  armcat_pattern_state_t *states; /* The states, indexed by bit. */
+  uint64_t *tables; /* The candidate bitsets of each value of each encoding field. */
+  uint64_t *summary; /* For each opcode byte, the state words it can start a match in. */
+  uint64_t *initial; /* The states of first steps. */
+  uint64_t *final; /* The states of last steps. */
+  uint64_t *gap_enter; /* The states preceding a gap. */
+  uint64_t *gap_exit; /* The last wildcard state of each gap. */
+  uint64_t *gap_states; /* The wildcard states of every gap. */
+} armcat_patternset_t;
+
+/* Structure containing the searches that failed while verifying a match, an open-addressing table. */
+typedef struct _armcat_pattern_memo {
+  uint64_t *keys; /* The step, the distance from the last instruction and the relevant bindings of each search. */
+  uint32_t *generations; /* The verification each slot was filled in, slots of older ones are empty. */
+  uint32_t generation; /* The current verification. */
+  size_t last; /* The last instruction of the match being verified. */
+} armcat_pattern_memo_t;
+
+/* Type-definition for the callback receiving each match, decoded. */
+typedef armcat_status_t (*armcat_pattern_callback_t)(void *context, const size_t pattern, const uint32_t address,
+  const armcat_instr_t *instructions, const size_t ninstr);
+
+void armcat_pattern_free(armcat_patternset_t *set);
+armcat_patternset_t *armcat_pattern_compile(const armcat_pattern_t *patterns, const size_t npatterns);
+
+armcat_status_t armcat_pattern_scan(const armcat_patternset_t *set, const void *buffer, const size_t nbytes,
+  const uint32_t base, armcat_pattern_callback_t callback, void *context);
+
+#endif
\ No newline at end of file
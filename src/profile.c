@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "profile.h"
+#include "disasm.h"
+
+
+/*
+    *    src/profile.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Sorts instruction indices with a least-significant-digit radix sort.
+ * @param indices The indices.
+ * @param scratch A scratch array of the same size.
+ * @param count The amount of indices.
+ * @param max The largest index.
+ * @returns The array holding the sorted indices, either indices or scratch.
+ */
+
+static uint32_t *profile_sort(uint32_t *indices, uint32_t *scratch, const size_t count, const uint32_t max) {
+  const size_t nbuckets = (size_t)1 << ARMCAT_PROFILE_RADIX_BITS;
+
+  size_t *buckets = malloc(nbuckets * sizeof(size_t));
+  if (!buckets)
+    return NULL;
+
+  for (uint32_t shift = 0; shift < 32 && (max >> shift); shift += ARMCAT_PROFILE_RADIX_BITS) {
+    memset(buckets, 0, nbuckets * sizeof(size_t));
+
+    for (size_t i = 0; i < count; ++i)
+      buckets[(indices[i] >> shift) & (nbuckets - 1)]++;
+
+    for (size_t i = 0, total = 0; i < nbuckets; ++i) {
+      const size_t amount = buckets[i];
+
+      buckets[i] = total;
+      total += amount;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+      scratch[buckets[(indices[i] >> shift) & (nbuckets - 1)]++] = indices[i];
+
+    uint32_t *sorted = scratch;
+
+    scratch = indices;
+    indices = sorted;
+  }
+
+  free(buckets);
+  return indices;
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the profile object.
+ * @param profile The profile object.
+ */
+
+void armcat_profile_free(armcat_profile_t *profile) {
+  free(profile->entries);
+  free(profile);
+}
+
+/**
+ * @brief Disassembles the windows around a batch of sampled addresses, counting the hits on each instruction.
+ * @param image The image.
+ * @param nbytes The size.
+ * @param base The address the image is loaded at.
+ * @param samples The sampled addresses.
+ * @param nsamples The amount of samples.
+ * @param window The amount of instructions to decode on each side of a sampled instruction, SIZE_MAX for the whole image.
+ * @returns A struct containing the annotated disassembly, NULL on failure.
+ */
+
+armcat_profile_t *armcat_profile(const void *image, const size_t nbytes, const uint32_t base,
+  const uint32_t *samples, const size_t nsamples, const size_t window)
+{
+  const size_t ninstr = nbytes / ARMCAT_INSTR_SIZEMAX;
+
+  /* A window past the image covers all of it, clamping it keeps the window arithmetic from wrapping. */
+  const size_t reach = (window < ninstr) ? window : ninstr;
+
+  armcat_profile_t *profile = calloc(1, sizeof(armcat_profile_t));
+  if (!profile)
+    return NULL;
+
+  uint32_t *indices = malloc((nsamples + 1) * sizeof(uint32_t));
+  uint32_t *scratch = malloc((nsamples + 1) * sizeof(uint32_t));
+
+  if (!indices || !scratch) {
+    free(indices);
+    free(scratch);
+    armcat_profile_free(profile);
+
+    return NULL;
+  }
+
+  uint32_t max = 0;
+
+  /* Turn the addresses into instruction indices, dropping the ones outside of the image. */
+  for (size_t i = 0; i < nsamples; ++i) {
+    const uint32_t index = (samples[i] - base) / ARMCAT_INSTR_SIZEMAX;
+
+    if (samples[i] < base || index >= ninstr)
+      continue;
+
+    indices[profile->nsamples++] = index;
+    max = (index > max) ? index : max;
+  }
+
+  uint32_t *sorted = profile_sort(indices, scratch, profile->nsamples, max);
+  if (!sorted) {
+    free(indices);
+    free(scratch);
+    armcat_profile_free(profile);
+
+    return NULL;
+  }
+
+  /* Deduplicate in place, the spare array receives the hit count of each distinct index. */
+  uint32_t *counts = (sorted == indices) ? scratch : indices;
+  size_t nhits = 0;
+
+  for (size_t i = 0; i < profile->nsamples; ++i) {
+    if (nhits && sorted[nhits - 1] == sorted[i]) {
+      counts[nhits - 1]++;
+      continue;
+    }
+
+    sorted[nhits] = sorted[i];
+    counts[nhits++] = 1;
+  }
+
+  /* Size the merged windows first, so the entries are allocated once. */
+  for (size_t i = 0, end = 0; i < nhits; ++i) {
+    const size_t start = (sorted[i] > reach) ? sorted[i] - reach : 0;
+    const size_t stop  = (sorted[i] + reach + 1 < ninstr) ? sorted[i] + reach + 1 : ninstr;
+
+    if (stop > end) {
+      profile->nentries += stop - ((start > end) ? start : end);
+      end = stop;
+    }
+  }
+
+  if (!(profile->entries = calloc(profile->nentries + 1, sizeof(armcat_profile_entry_t)))) {
+    free(indices);
+    free(scratch);
+    armcat_profile_free(profile);
+
+    return NULL;
+  }
+
+  armcat_profile_entry_t *entry = profile->entries;
+
+  for (size_t i = 0, end = 0, k = 0; i < nhits; ++i) {
+    const size_t start = (sorted[i] > reach) ? sorted[i] - reach : 0;
+    const size_t stop  = (sorted[i] + reach + 1 < ninstr) ? sorted[i] + reach + 1 : ninstr;
+
+    for (size_t index = (start > end) ? start : end; index < stop; ++index, ++entry) {
+      /* Hits are sorted, so the next one to attribute is always at k. */
+      while (k < nhits && sorted[k] < index)
+        ++k;
+
+      entry->address = base + index * ARMCAT_INSTR_SIZEMAX;
+      entry->hits    = (k < nhits && sorted[k] == index) ? counts[k] : 0;
+
+      disasm_instr(&entry->instr, *(uint32_t *)(image + index * ARMCAT_INSTR_SIZEMAX));
+    }
+
+    end = (stop > end) ? stop : end;
+  }
+
+  free(indices);
+  free(scratch);
+
+  return profile;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+#define ARMCAT_PROFILE_RADIX_BITS 16 /* Bits sorted per radix sort pass. */
+
+
+/*
+    *    src/profile.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing a decoded instruction near a sampled address. */
+typedef struct _armcat_profile_entry {
+  uint32_t address; /* The address of the instruction. */
+  uint32_t hits; /* The amount of samples that hit the instruction. */
+  armcat_instr_t instr; /* The disassembly data. */
+} armcat_profile_entry_t;
+
+/* Structure containing the annotated windows around every sampled address. */
+typedef struct _armcat_profile {
+  size_t nsamples; /* The amount of samples that fell inside the image. */
+  size_t nentries; /* The amount of instructions. */
+  armcat_profile_entry_t *entries; /* A dynamically-allocated array of instructions, in address order. */
+} armcat_profile_t;
+
+void armcat_profile_free(armcat_profile_t *profile);
+
+armcat_profile_t *armcat_profile(const void *image, const size_t nbytes, const uint32_t base,
+  const uint32_t *samples, const size_t nsamples, const size_t window);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "hash.h"
+#include "armcat.h"
+#include "decode.h"
+#include "disasm.h"
+
+#define ARMCAT_SWEEP_CHUNK   (1ull << 20) /* Encodings per chunk, the unit of work and of the digest. */
+#define ARMCAT_SWEEP_END     (1ull << 32) /* One past the last encoding. */
+#define ARMCAT_SWEEP_GROUPS  5 /* The instruction groups, plus encodings not named by a table entry. */
+#define ARMCAT_SWEEP_THREADS 256 /* Maximum amount of worker threads. */
+
+
+/*
+    *    src/sweep.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure containing the state shared by the sweep workers. */
+typedef struct _armcat_sweep {
+  uint64_t start; /* The first encoding. */
+  uint64_t end; /* One past the last encoding. */
+  uint64_t nchunks; /* The amount of chunks. */
+  uint64_t next; /* The next chunk to claim. */
+  uint64_t *digests; /* The digest of each chunk. */
+} armcat_sweep_t;
+
+/* Structure containing the histogram of a worker, merged once it finishes. */
+typedef struct _armcat_sweep_worker {
+  pthread_t thread; /* The thread. */
+  armcat_sweep_t *sweep; /* The shared state. */
+  uint64_t decoded[ARMCAT_SWEEP_GROUPS]; /* Encodings that decoded, per group. */
+  uint64_t failed[ARMCAT_SWEEP_GROUPS]; /* Encodings that did not decode, per group. */
+} armcat_sweep_worker_t;
+
+/* Names of the histogram rows, in armcat_instr_group_t order! */
+static const char *group_names[ARMCAT_SWEEP_GROUPS] = {
+  "branching", "load/store", "miscellaneous", "data-processing", "(no opcode)"
+};
+
+/**
+ * @brief Decodes chunks of encodings until none are left.
+ * @param argument The worker.
+ * @returns NULL.
+ */
+
+static void *sweep_worker(void *argument) {
+  armcat_sweep_worker_t *worker = argument;
+  armcat_sweep_t *sweep = worker->sweep;
+
+  for (uint64_t chunk; (chunk = __atomic_fetch_add(&sweep->next, 1, __ATOMIC_RELAXED)) < sweep->nchunks;) {
+    const uint64_t first = sweep->start + chunk * ARMCAT_SWEEP_CHUNK;
+    const uint64_t last  = (first + ARMCAT_SWEEP_CHUNK < sweep->end) ? first + ARMCAT_SWEEP_CHUNK : sweep->end;
+
+    uint64_t digest = first;
+
+    for (uint64_t encoding = first; encoding < last; ++encoding) {
+      armcat_instr_t instr = {0};
+
+      const armcat_opcode_table_t *info = NULL;
+      const armcat_status_t status = disasm_instr_opcode(&instr, (uint32_t)encoding, &info);
+
+      /* Grouped by the entry the printed mnemonic came from, names formatted outside the table have none. */
+      const size_t group = info ? info->group : ARMCAT_SWEEP_GROUPS - 1;
+
+      if (status == ARMCAT_STATUS_SUCCESS)
+        worker->decoded[group]++;
+      else
+        worker->failed[group]++;
+
+      /* The instruction is zeroed first, so the whole structure (text, masks, flags, status) is deterministic. */
+      digest = hash_buffer(&instr, sizeof(instr), digest);
+    }
+
+    sweep->digests[chunk] = digest;
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Decodes every encoding in a range across all cores, printing a histogram, a digest and the wall time.
+ * @param argc The amount of arguments.
+ * @param argv The arguments, an optional hex range "start end" and "-c" to print the digest of every chunk.
+ * @returns 0 on success, 1 on failure.
+ */
+
+int main(int argc, char **argv) {
+  armcat_sweep_t sweep = { .start = 0, .end = ARMCAT_SWEEP_END };
+  int verbose = 0;
+
+  for (int i = 1, range = 0; i < argc; ++i) {
+    if (!strcmp(argv[i], "-c")) {
+      verbose = 1;
+      continue;
+    }
+
+    char *end = NULL;
+    const unsigned long long value = strtoull(argv[i], &end, 16);
+
+    if (*end || range > 1 || value > ARMCAT_SWEEP_END) {
+      fprintf(stderr, "usage: %s [-c] [start end]\n", argv[0]);
+      return 1;
+    }
+
+    *(range++ ? &sweep.end : &sweep.start) = value;
+  }
+
+  if (sweep.start >= sweep.end) {
+    fprintf(stderr, "[error]: empty range\n");
+    return 1;
+  }
+
+  sweep.nchunks = (sweep.end - sweep.start + ARMCAT_SWEEP_CHUNK - 1) / ARMCAT_SWEEP_CHUNK;
+
+  if (!(sweep.digests = calloc(sweep.nchunks, sizeof(uint64_t))))
+    return 1;
+
+  const long online = sysconf(_SC_NPROCESSORS_ONLN);
+  const size_t nthreads = (online < 1) ? 1 : (online > ARMCAT_SWEEP_THREADS) ? ARMCAT_SWEEP_THREADS : online;
+
+  armcat_sweep_worker_t *workers = calloc(nthreads, sizeof(armcat_sweep_worker_t));
+  if (!workers) {
+    free(sweep.digests);
+    return 1;
+  }
+
+  struct timespec started, finished;
+  clock_gettime(CLOCK_MONOTONIC, &started);
+
+  size_t nthreaded = 0;
+
+  for (; nthreaded < nthreads; ++nthreaded) {
+    workers[nthreaded].sweep = &sweep;
+
+    if (pthread_create(&workers[nthreaded].thread, NULL, sweep_worker, &workers[nthreaded]))
+      break;
+  }
+
+  /* Threads that did start drain every chunk between them, without any the sweep runs here. */
+  if (!nthreaded)
+    sweep_worker(&workers[0]);
+
+  for (size_t i = 0; i < nthreaded; ++i)
+    pthread_join(workers[i].thread, NULL);
+
+  clock_gettime(CLOCK_MONOTONIC, &finished);
+
+  const double seconds = (finished.tv_sec - started.tv_sec) + (finished.tv_nsec - started.tv_nsec) / 1e9;
+
+  uint64_t decoded[ARMCAT_SWEEP_GROUPS] = {0}, failed[ARMCAT_SWEEP_GROUPS] = {0}, digest = 0;
+
+  for (size_t i = 0; i < nthreads; ++i)
+    for (size_t group = 0; group < ARMCAT_SWEEP_GROUPS; ++group) {
+      decoded[group] += workers[i].decoded[group];
+      failed[group]  += workers[i].failed[group];
+    }
+
+  /* Chunk digests are combined in order, so the result does not depend on the scheduling. */
+  for (uint64_t chunk = 0; chunk < sweep.nchunks; ++chunk) {
+    if (verbose)
+      printf("chunk %08llx: %016llx\n", (unsigned long long)(sweep.start + chunk * ARMCAT_SWEEP_CHUNK), 
+        (unsigned long long)sweep.digests[chunk]);
+
+    digest = hash_buffer(&sweep.digests[chunk], sizeof(uint64_t), digest);
+  }
+
+  printf("%-16s %12s %12s\n", "group", "decoded", "failed");
+
+  for (size_t group = 0; group < ARMCAT_SWEEP_GROUPS; ++group)
+    printf("%-16s %12llu %12llu\n", group_names[group], (unsigned long long)decoded[group], 
+      (unsigned long long)failed[group]);
+
+  printf("range:   %08llx-%08llx\n", (unsigned long long)sweep.start, (unsigned long long)(sweep.end - 1));
+  printf("digest:  %016llx\n", (unsigned long long)digest);
+  printf("threads: %zu\n", nthreaded ? nthreaded : 1);
+  printf("time:    %.3fs (%.1fM instr/s)\n", seconds, (sweep.end - sweep.start) / seconds / 1e6);
+
+  free(workers);
+  free(sweep.digests);
+
+  return 0;
+}
\ No newline at end of file
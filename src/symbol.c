@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <elf.h>
+
+#include "symbol.h"
+#include "decode.h"
+#include "disasm.h"
+
+
+/*
+    *    src/symbol.c
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/**
+ * @brief Compares two symbols by address, then by name.
+ * @param a The first symbol.
+ * @param b The second symbol.
+ * @returns A negative, zero or positive value, like strcmp.
+ */
+
+static int symtab_compare(const void *a, const void *b) {
+  const armcat_symbol_t *x = a, *y = b;
+
+  if (x->address != y->address)
+    return (x->address < y->address) ? -1 : 1;
+
+  return strcmp(x->name, y->name);
+}
+
+/**
+ * @brief Lays the sorted addresses out in Eytzinger order.
+ * @param symtab The symbol table.
+ * @param i The next sorted rank to place.
+ * @param k The Eytzinger slot.
+ * @returns The next sorted rank to place.
+ */
+
+static size_t symtab_eytzinger(armcat_symtab_t *symtab, size_t i, const size_t k) {
+  if (k > symtab->nsymbols)
+    return i;
+
+  i = symtab_eytzinger(symtab, i, 2 * k);
+
+  symtab->addresses[k] = symtab->sorted[i];
+  symtab->ranks[k] = i++;
+
+  return symtab_eytzinger(symtab, i, 2 * k + 1);
+}
+
+/**
+ * @brief Deallocates the memory that was allocated for the symbol table.
+ * @param symtab The symbol table.
+ */
+
+void armcat_symtab_free(armcat_symtab_t *symtab) {
+  free(symtab->addresses);
+  free(symtab->ranks);
+  free(symtab->names);
+  free(symtab->sorted);
+  free(symtab->strings);
+  free(symtab);
+}
+
+/**
+ * @brief Creates a symbol table from caller-supplied symbols, the names are copied.
+ * @param symbols The symbols.
+ * @param nsymbols The amount of symbols.
+ * @returns The symbol table, NULL on failure.
+ */
+
+armcat_symtab_t *armcat_symtab_create(const armcat_symbol_t *symbols, const size_t nsymbols) {
+  armcat_symtab_t *symtab = calloc(1, sizeof(armcat_symtab_t));
+  if (!symtab)
+    return NULL;
+
+  armcat_symbol_t *sorted = malloc((nsymbols + 1) * sizeof(armcat_symbol_t));
+  if (!sorted) {
+    free(symtab);
+
+    return NULL;
+  }
+
+  memcpy(sorted, symbols, nsymbols * sizeof(armcat_symbol_t));
+  qsort(sorted, nsymbols, sizeof(armcat_symbol_t), symtab_compare);
+
+  size_t nunique = 0, pool = 0;
+
+  /* Keep a single name per address. */
+  for (size_t i = 0; i < nsymbols; ++i) {
+    if (nunique && sorted[nunique - 1].address == sorted[i].address)
+      continue;
+
+    sorted[nunique++] = sorted[i];
+    pool += strlen(sorted[i].name) + 1;
+  }
+
+  symtab->nsymbols  = nunique;
+  symtab->addresses = malloc((nunique + 1) * sizeof(uint32_t));
+  symtab->ranks     = malloc((nunique + 1) * sizeof(uint32_t));
+  symtab->names     = malloc((nunique + 1) * sizeof(uint32_t));
+  symtab->sorted    = malloc((nunique + 1) * sizeof(uint32_t));
+  symtab->strings   = malloc(pool + 1);
+
+  if (!symtab->addresses || !symtab->ranks || !symtab->names || !symtab->sorted || !symtab->strings) {
+    free(sorted);
+    armcat_symtab_free(symtab);
+
+    return NULL;
+  }
+
+  for (size_t i = 0, offset = 0; i < nunique; ++i) {
+    const size_t length = strlen(sorted[i].name) + 1;
+
+    memcpy(&symtab->strings[offset], sorted[i].name, length);
+
+    symtab->names[i]  = offset;
+    symtab->sorted[i] = sorted[i].address;
+
+    offset += length;
+  }
+
+  free(sorted);
+  symtab_eytzinger(symtab, 0, 1);
+
+  return symtab;
+}
+
+/**
+ * @brief Reads a section header of an ELF image, which may not be aligned in the caller's buffer.
+ * @param image The ELF image.
+ * @param header The ELF header.
+ * @param i The section index.
+ * @returns The section header.
+ */
+
+static inline __always_inline Elf32_Shdr symtab_section(const void *image, const Elf32_Ehdr *header, const size_t i) {
+  Elf32_Shdr section;
+  memcpy(&section, image + header->e_shoff + i * sizeof(Elf32_Shdr), sizeof(Elf32_Shdr));
+
+  return section;
+}
+
+/**
+ * @brief Creates a symbol table from the .symtab and .dynsym sections of a 32-bit little-endian ELF image.
+ * @param image The ELF image.
+ * @param nbytes The size.
+ * @returns The symbol table, NULL on failure.
+ */
+
+armcat_symtab_t *armcat_symtab_load_elf(const void *image, const size_t nbytes) {
+  Elf32_Ehdr header;
+
+  if (nbytes < sizeof(Elf32_Ehdr))
+    return NULL;
+
+  memcpy(&header, image, sizeof(Elf32_Ehdr));
+
+  /* Big-endian (armeb) images would need every field byte-swapped, they are rejected instead. */
+  if (memcmp(header.e_ident, ELFMAG, SELFMAG) || header.e_ident[EI_CLASS] != ELFCLASS32
+    || header.e_ident[EI_DATA] != ELFDATA2LSB || header.e_shentsize != sizeof(Elf32_Shdr)
+    || header.e_shoff > nbytes || (nbytes - header.e_shoff) / sizeof(Elf32_Shdr) < header.e_shnum)
+    return NULL;
+
+  size_t nsymbols = 0;
+
+  for (size_t i = 0; i < header.e_shnum; ++i) {
+    const Elf32_Shdr section = symtab_section(image, &header, i);
+
+    if ((section.sh_type == SHT_SYMTAB || section.sh_type == SHT_DYNSYM) 
+      && section.sh_offset <= nbytes && section.sh_size <= nbytes - section.sh_offset)
+      nsymbols += section.sh_size / sizeof(Elf32_Sym);
+  }
+
+  armcat_symbol_t *symbols = malloc((nsymbols + 1) * sizeof(armcat_symbol_t));
+  if (!symbols)
+    return NULL;
+
+  nsymbols = 0;
+
+  for (size_t i = 0; i < header.e_shnum; ++i) {
+    const Elf32_Shdr section = symtab_section(image, &header, i);
+
+    if ((section.sh_type != SHT_SYMTAB && section.sh_type != SHT_DYNSYM) || section.sh_link >= header.e_shnum
+      || section.sh_offset > nbytes || section.sh_size > nbytes - section.sh_offset)
+      continue;
+
+    const Elf32_Shdr strtab = symtab_section(image, &header, section.sh_link);
+    if (strtab.sh_offset > nbytes || strtab.sh_size > nbytes - strtab.sh_offset || !strtab.sh_size)
+      continue;
+
+    const char *strings = image + strtab.sh_offset;
+
+    /* The string table must be terminated for the names to be safe to read. */
+    if (strings[strtab.sh_size - 1])
+      continue;
+
+    for (size_t j = 0; j < section.sh_size / sizeof(Elf32_Sym); ++j) {
+      Elf32_Sym entry;
+      memcpy(&entry, image + section.sh_offset + j * sizeof(Elf32_Sym), sizeof(Elf32_Sym));
+
+      const int type = ELF32_ST_TYPE(entry.st_info);
+
+      if (entry.st_shndx == SHN_UNDEF || !entry.st_name || entry.st_name >= strtab.sh_size
+        || (type != STT_FUNC && type != STT_OBJECT && type != STT_NOTYPE))
+        continue;
+
+      /* Skip the ARM mapping symbols ($a, $t, $d). */
+      if (strings[entry.st_name] == '$')
+        continue;
+
+      symbols[nsymbols++] = (armcat_symbol_t) {
+        .address = (type == STT_FUNC) ? (entry.st_value & ~1u) : entry.st_value,
+        .name    = &strings[entry.st_name]
+      };
+    }
+  }
+
+  armcat_symtab_t *symtab = armcat_symtab_create(symbols, nsymbols);
+
+  free(symbols);
+  return symtab;
+}
+
+/**
+ * @brief Finds the symbol containing an address, the closest one at or below it.
+ * @param symtab The symbol table.
+ * @param address The address.
+ * @param offset Receives the offset of the address from the symbol, may be NULL.
+ * @returns The name of the symbol, NULL if no symbol lies at or below the address.
+ */
+
+const char *armcat_symtab_lookup(const armcat_symtab_t *symtab, const uint32_t address, uint32_t *offset) {
+  size_t k = 1;
+
+  while (k <= symtab->nsymbols) {
+    __builtin_prefetch(&symtab->addresses[16 * k]);
+    k = 2 * k + (symtab->addresses[k] <= address);
+  }
+
+  /* Undo the trailing right turns, leaving the slot of the first address above the target (or 0). */
+  k >>= __builtin_ffsll(~(long long)k);
+
+  const size_t rank = k ? symtab->ranks[k] : symtab->nsymbols;
+  if (!rank)
+    return NULL;
+
+  if (offset)
+    *offset = address - symtab->sorted[rank - 1];
+
+  return &symtab->strings[symtab->names[rank - 1]];
+}
+
+/**
+ * @brief Rewrites the target of an immediate branch as symbol+offset.
+ * @param instr A structure containing the decoded instruction attributes.
+ * @param address The address of the instruction.
+ * @param symtab The symbol table.
+ */
+
+static void symtab_format_branch(armcat_instr_t *instr, const uint32_t address, const armcat_symtab_t *symtab) {
+  uint32_t target = address + 8 + (ARMCAT_OPERAND_EXTEND(instr->instr, 24) << 2), offset = 0;
+
+  /* BLX (immediate) carries a halfword bit in bit 24. */
+  if (ARMCAT_CONDITION_CODE_DECODE(instr->instr) == ARMCAT_CONDITION_CODE_UNCONDITIONAL)
+    target += ARMCAT_PARSE_BITS(instr->instr, 24, 24) << 1;
+
+  const char *name = armcat_symtab_lookup(symtab, target, &offset);
+  char *operand = strchr(instr->disasm_instr, '\t');
+
+  if (!name || !operand)
+    return;
+
+  const size_t size = ARMCAT_DISASM_INSTR_SIZEMAX - (++operand - instr->disasm_instr);
+
+  if (offset)
+    snprintf(operand, size, "%s+0x%x", name, offset);
+  else
+    snprintf(operand, size, "%s", name);
+}
+
+/**
+ * @brief Disassembles a given buffer, naming the targets of immediate branches after their symbols.
+ * @param buffer The buffer.
+ * @param nbytes The size.
+ * @param base The address the buffer is loaded at.
+ * @param symtab The symbol table.
+ * @returns A struct containing the disassembly data.
+ */
+
+armcat_disasm_t *armcat_disasm_symbolized(const void *buffer, const size_t nbytes, const uint32_t base,
+  const armcat_symtab_t *symtab)
+{
+  armcat_disasm_t *disassembly = armcat_disasm(buffer, nbytes);
+  if (!disassembly)
+    return NULL;
+
+  for (size_t i = 0; i < disassembly->ninstr; ++i)
+    if (ARMCAT_INSTR_VALID(disassembly, i) && ARMCAT_BRANCH_IMMEDIATE_DECODE(disassembly->instructions[i].instr))
+      symtab_format_branch(&disassembly->instructions[i], base + i * ARMCAT_INSTR_SIZEMAX, symtab);
+
+  return disassembly;
+}
\ No newline at end of file
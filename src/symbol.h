@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2023 xmmword
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __SYMBOL_H
+#define __SYMBOL_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "armcat.h"
+
+
+/*
+    *    src/symbol.h
+    *    Date: 10/18/26
+    *    Author: @xmmword
+*/
+
+
+/* Structure describing a symbol supplied by the caller. */
+typedef struct _armcat_symbol {
+  uint32_t address; /* The address of the symbol. */
+  const char *name; /* The name of the symbol. */
+} armcat_symbol_t;
+
+/* Structure containing a symbol table laid out for fast address lookups. */
+typedef struct _armcat_symtab {
+  size_t nsymbols; /* The amount of symbols. */
+  uint32_t *addresses; /* The symbol addresses in Eytzinger (BFS) order, starting at index 1. */
+  uint32_t *ranks; /* The sorted rank of each Eytzinger slot. */
+  uint32_t *names; /* Offsets into the string pool, in sorted order. */
+  uint32_t *sorted; /* The symbol addresses in sorted order. */
+  char *strings; /* The string pool containing every symbol name. */
+} armcat_symtab_t;
+
+void armcat_symtab_free(armcat_symtab_t *symtab);
+
+armcat_symtab_t *armcat_symtab_create(const armcat_symbol_t *symbols, const size_t nsymbols);
+armcat_symtab_t *armcat_symtab_load_elf(const void *image, const size_t nbytes);
+
+const char *armcat_symtab_lookup(const armcat_symtab_t *symtab, const uint32_t address, uint32_t *offset);
+
+armcat_disasm_t *armcat_disasm_symbolized(const void *buffer, const size_t nbytes, const uint32_t base,
+  const armcat_symtab_t *symtab);
+
+#endif
\ No newline at end of file